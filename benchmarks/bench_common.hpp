@@ -0,0 +1,150 @@
+#pragma once
+
+/**
+ * @file bench_common.hpp
+ * @brief Shared helpers for cpp-threadpool benchmarks
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Distribution summary of a set of samples
+ */
+struct Percentiles {
+    size_t count = 0;
+    double mean = 0.0;
+    double p50 = 0.0;
+    double p90 = 0.0;
+    double p99 = 0.0;
+    double p999 = 0.0;
+    double max = 0.0;
+};
+
+/**
+ * @brief Compute percentiles (nearest-rank) of the given samples
+ */
+inline Percentiles percentiles(std::vector<double> samples) {
+    Percentiles result;
+    if (samples.empty()) {
+        return result;
+    }
+    
+    std::sort(samples.begin(), samples.end());
+    auto rank = [&samples](double q) {
+        size_t idx = static_cast<size_t>(q * static_cast<double>(samples.size() - 1) + 0.5);
+        return samples[std::min(idx, samples.size() - 1)];
+    };
+    
+    result.count = samples.size();
+    result.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(samples.size());
+    result.p50 = rank(0.50);
+    result.p90 = rank(0.90);
+    result.p99 = rank(0.99);
+    result.p999 = rank(0.999);
+    result.max = samples.back();
+    return result;
+}
+
+/**
+ * @brief Microseconds between two time points
+ */
+inline double micros(Clock::time_point from, Clock::time_point to) {
+    return std::chrono::duration<double, std::micro>(to - from).count();
+}
+
+/**
+ * @brief Busy-wait for the given duration (simulated CPU work)
+ */
+inline void spin_for(std::chrono::nanoseconds duration) {
+    if (duration.count() <= 0) {
+        return;
+    }
+    auto end = Clock::now() + duration;
+    while (Clock::now() < end) {
+    }
+}
+
+/**
+ * @brief Busy-wait until the given time point
+ */
+inline void spin_until(Clock::time_point deadline) {
+    while (Clock::now() < deadline) {
+    }
+}
+
+/**
+ * @brief Thread counts 1, 2, 4, ... followed by max itself
+ */
+inline std::vector<size_t> thread_sweep(size_t max) {
+    std::vector<size_t> counts;
+    for (size_t t = 1; t < max; t *= 2) {
+        counts.push_back(t);
+    }
+    counts.push_back(std::max<size_t>(max, 1));
+    return counts;
+}
+
+/**
+ * @brief Read "--name value" from the command line, or return a default
+ */
+inline size_t arg_value(int argc, char** argv, const std::string& name, size_t default_value) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (argv[i] == "--" + name) {
+            return static_cast<size_t>(std::strtoull(argv[i + 1], nullptr, 10));
+        }
+    }
+    return default_value;
+}
+
+/**
+ * @brief Read "--name value" as a string, or return a default
+ */
+inline std::string arg_string(int argc, char** argv, const std::string& name, const std::string& default_value) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (argv[i] == "--" + name) {
+            return argv[i + 1];
+        }
+    }
+    return default_value;
+}
+
+/**
+ * @brief Print the header matching print_percentiles()
+ */
+inline void print_percentiles_header(const std::string& label, const std::string& unit) {
+    std::cout << std::left << std::setw(32) << label
+              << std::right << std::setw(10) << "count"
+              << std::setw(12) << ("p50 " + unit)
+              << std::setw(12) << ("p99 " + unit)
+              << std::setw(12) << ("p999 " + unit)
+              << std::setw(12) << ("max " + unit)
+              << std::endl;
+    std::cout << std::string(90, '-') << std::endl;
+}
+
+/**
+ * @brief Print one row of percentiles
+ */
+inline void print_percentiles(const std::string& label, const Percentiles& p) {
+    std::cout << std::left << std::setw(32) << label
+              << std::right << std::setw(10) << p.count
+              << std::fixed << std::setprecision(2)
+              << std::setw(12) << p.p50
+              << std::setw(12) << p.p99
+              << std::setw(12) << p.p999
+              << std::setw(12) << p.max
+              << std::endl;
+}
+
+} // namespace bench
@@ -211,19 +211,21 @@ BenchmarkResult benchmark_mixed_workload(tp::ThreadPool& pool, size_t num_tasks)
     };
 }
 
+#if defined(THREADPOOL_HAS_PMR)
 /**
- * @brief Benchmark: Priority tasks
+ * @brief Benchmark: Memory allocation from the worker scratch arena
  */
-BenchmarkResult benchmark_priority_tasks(tp::ThreadPool& pool, size_t num_tasks) {
-    std::vector<std::future<int>> futures;
+BenchmarkResult benchmark_memory_alloc_scratch(tp::ThreadPool& pool, size_t num_tasks) {
+    std::vector<std::future<size_t>> futures;
     futures.reserve(num_tasks);
     
     auto start = Clock::now();
     
     for (size_t i = 0; i < num_tasks; ++i) {
-        int priority = static_cast<int>(i % 10);
-        futures.push_back(pool.submit_priority(priority, [i] {
-            return static_cast<int>(i * i);
+        futures.push_back(pool.submit([i] {
+            std::pmr::vector<int> vec(1000, &tp::this_worker::scratch());
+            std::iota(vec.begin(), vec.end(), static_cast<int>(i));
+            return std::accumulate(vec.begin(), vec.end(), 0UL);
         }));
     }
     
@@ -235,7 +237,7 @@ BenchmarkResult benchmark_priority_tasks(tp::ThreadPool& pool, size_t num_tasks)
     Duration elapsed = end - start;
     
     return {
-        "Priority tasks (10 levels)",
+        "Memory alloc (1K, scratch)",
         num_tasks,
         elapsed.count(),
         (num_tasks / elapsed.count()) * 1000.0
@@ -243,58 +245,70 @@ BenchmarkResult benchmark_priority_tasks(tp::ThreadPool& pool, size_t num_tasks)
 }
 
 /**
- * @brief Compare single-threaded vs thread pool
+ * @brief Benchmark: Mixed workload with temporaries in the scratch arena
  */
-void benchmark_scaling() {
-    std::cout << "\n=== Scaling Benchmark ===" << std::endl;
-    
-    const size_t num_tasks = 10000;
+BenchmarkResult benchmark_mixed_workload_scratch(tp::ThreadPool& pool, size_t num_tasks) {
+    std::vector<std::future<double>> futures;
+    futures.reserve(num_tasks);
     
-    // Single-threaded
     auto start = Clock::now();
-    double result = 0.0;
+    
     for (size_t i = 0; i < num_tasks; ++i) {
-        for (int j = 0; j < 1000; ++j) {
-            result += std::sin(static_cast<double>(i + j));
-        }
+        futures.push_back(pool.submit([i] {
+            std::pmr::vector<double> vec(100, &tp::this_worker::scratch());
+            for (size_t j = 0; j < vec.size(); ++j) {
+                vec[j] = std::sin(static_cast<double>(i + j));
+            }
+            std::sort(vec.begin(), vec.end());
+            return std::accumulate(vec.begin(), vec.end(), 0.0);
+        }));
+    }
+    
+    for (auto& f : futures) {
+        f.get();
     }
+    
     auto end = Clock::now();
-    Duration single_time = end - start;
-    
-    std::cout << "Single-threaded: " << std::fixed << std::setprecision(2) 
-              << single_time.count() << " ms" << std::endl;
-    
-    // Thread pool with different thread counts
-    for (size_t num_threads : {1, 2, 4, 8}) {
-        tp::ThreadPool pool(num_threads);
-        
-        std::vector<std::future<double>> futures;
-        futures.reserve(num_tasks);
-        
-        start = Clock::now();
-        
-        for (size_t i = 0; i < num_tasks; ++i) {
-            futures.push_back(pool.submit([i] {
-                double r = 0.0;
-                for (int j = 0; j < 1000; ++j) {
-                    r += std::sin(static_cast<double>(i + j));
-                }
-                return r;
-            }));
-        }
-        
-        for (auto& f : futures) {
-            f.get();
-        }
-        
-        end = Clock::now();
-        Duration pool_time = end - start;
-        
-        double speedup = single_time.count() / pool_time.count();
-        
-        std::cout << num_threads << " threads: " << std::fixed << std::setprecision(2)
-                  << pool_time.count() << " ms (speedup: " << speedup << "x)" << std::endl;
+    Duration elapsed = end - start;
+    
+    return {
+        "Mixed workload (scratch)",
+        num_tasks,
+        elapsed.count(),
+        (num_tasks / elapsed.count()) * 1000.0
+    };
+}
+#endif
+
+/**
+ * @brief Benchmark: Priority tasks
+ */
+BenchmarkResult benchmark_priority_tasks(tp::ThreadPool& pool, size_t num_tasks) {
+    std::vector<std::future<int>> futures;
+    futures.reserve(num_tasks);
+    
+    auto start = Clock::now();
+    
+    for (size_t i = 0; i < num_tasks; ++i) {
+        int priority = static_cast<int>(i % 10);
+        futures.push_back(pool.submit_priority(priority, [i] {
+            return static_cast<int>(i * i);
+        }));
+    }
+    
+    for (auto& f : futures) {
+        f.get();
     }
+    
+    auto end = Clock::now();
+    Duration elapsed = end - start;
+    
+    return {
+        "Priority tasks (10 levels)",
+        num_tasks,
+        elapsed.count(),
+        (num_tasks / elapsed.count()) * 1000.0
+    };
 }
 
 int main() {
@@ -320,7 +334,13 @@ int main() {
     results.push_back(benchmark_light_compute(pool, 100000));
     results.push_back(benchmark_heavy_compute(pool, 10000));
     results.push_back(benchmark_memory_alloc(pool, 100000));
+#if defined(THREADPOOL_HAS_PMR)
+    results.push_back(benchmark_memory_alloc_scratch(pool, 100000));
+#endif
     results.push_back(benchmark_mixed_workload(pool, 50000));
+#if defined(THREADPOOL_HAS_PMR)
+    results.push_back(benchmark_mixed_workload_scratch(pool, 50000));
+#endif
     results.push_back(benchmark_priority_tasks(pool, 100000));
     
     // Print results
@@ -333,8 +353,7 @@ int main() {
     std::cout << "Total tasks completed: " << stats.total_tasks_completed << std::endl;
     std::cout << "Total tasks stolen: " << stats.total_tasks_stolen << std::endl;
     
-    // Scaling benchmark
-    benchmark_scaling();
+    std::cout << "\n(Run benchmark_scaling for the thread-count sweep)" << std::endl;
     
     std::cout << "\n=== Benchmarks Complete ===" << std::endl;
     
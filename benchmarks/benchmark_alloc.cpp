@@ -0,0 +1,378 @@
+/**
+ * @file benchmark_alloc.cpp
+ * @brief Heap allocations per submitted task and memory footprint of a full queue
+ * 
+ * Usage: benchmark_alloc [--tasks N] [--queued N] [--threads N]
+ * 
+ * Global operator new/delete are replaced with counting versions. Configure
+ * with -DTHREADPOOL_BENCH_COUNT_MALLOC=ON (glibc only) to also count raw
+ * malloc/calloc/realloc calls made outside operator new.
+ */
+
+#include "bench_common.hpp"
+
+#include <threadpool/threadpool.hpp>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+// ---------------------------------------------------------------------------
+// Allocation counters
+// ---------------------------------------------------------------------------
+
+namespace counters {
+
+std::atomic<uint64_t> allocations{0};
+std::atomic<uint64_t> bytes{0};
+std::atomic<int64_t> live_bytes{0};
+std::atomic<int64_t> peak_live_bytes{0};
+std::atomic<uint64_t> malloc_calls{0};
+
+void record_alloc(size_t size) noexcept {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    bytes.fetch_add(size, std::memory_order_relaxed);
+    int64_t live = live_bytes.fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed) 
+                 + static_cast<int64_t>(size);
+    int64_t peak = peak_live_bytes.load(std::memory_order_relaxed);
+    while (live > peak && !peak_live_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+}
+
+void record_free(size_t size) noexcept {
+    live_bytes.fetch_sub(static_cast<int64_t>(size), std::memory_order_relaxed);
+}
+
+/**
+ * @brief Snapshot used to compute per-phase deltas
+ */
+struct Snapshot {
+    uint64_t allocations;
+    uint64_t bytes;
+    uint64_t malloc_calls;
+    
+    static Snapshot now() {
+        return {counters::allocations.load(), counters::bytes.load(), counters::malloc_calls.load()};
+    }
+};
+
+} // namespace counters
+
+#if defined(BENCH_COUNT_MALLOC) && defined(__GLIBC__)
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void __libc_free(void* ptr);
+
+void* malloc(size_t size) {
+    counters::malloc_calls.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+void* calloc(size_t count, size_t size) {
+    counters::malloc_calls.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+void* realloc(void* ptr, size_t size) {
+    counters::malloc_calls.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+void free(void* ptr) {
+    __libc_free(ptr);
+}
+}
+#define BENCH_RAW_MALLOC __libc_malloc
+#define BENCH_RAW_FREE __libc_free
+#else
+#define BENCH_RAW_MALLOC std::malloc
+#define BENCH_RAW_FREE std::free
+#endif
+
+namespace {
+
+// Stored just below every block handed out by operator new
+struct BlockHeader {
+    void* raw;
+    size_t size;
+};
+
+void* counted_alloc(size_t size, size_t align) noexcept {
+    align = std::max(align, alignof(std::max_align_t));
+    void* raw = BENCH_RAW_MALLOC(size + align + sizeof(BlockHeader));
+    if (!raw) {
+        return nullptr;
+    }
+    uintptr_t p = reinterpret_cast<uintptr_t>(raw) + sizeof(BlockHeader);
+    p = (p + align - 1) & ~(static_cast<uintptr_t>(align) - 1);
+    BlockHeader* header = reinterpret_cast<BlockHeader*>(p) - 1;
+    header->raw = raw;
+    header->size = size;
+    counters::record_alloc(size);
+    return reinterpret_cast<void*>(p);
+}
+
+void counted_free(void* ptr) noexcept {
+    if (!ptr) {
+        return;
+    }
+    BlockHeader* header = static_cast<BlockHeader*>(ptr) - 1;
+    counters::record_free(header->size);
+    BENCH_RAW_FREE(header->raw);
+}
+
+void* counted_alloc_or_throw(size_t size, size_t align) {
+    void* p = counted_alloc(size, align);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+} // namespace
+
+void* operator new(size_t size) { return counted_alloc_or_throw(size, 0); }
+void* operator new[](size_t size) { return counted_alloc_or_throw(size, 0); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return counted_alloc(size, 0); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return counted_alloc(size, 0); }
+void* operator new(size_t size, std::align_val_t al) { return counted_alloc_or_throw(size, static_cast<size_t>(al)); }
+void* operator new[](size_t size, std::align_val_t al) { return counted_alloc_or_throw(size, static_cast<size_t>(al)); }
+void* operator new(size_t size, std::align_val_t al, const std::nothrow_t&) noexcept { return counted_alloc(size, static_cast<size_t>(al)); }
+void* operator new[](size_t size, std::align_val_t al, const std::nothrow_t&) noexcept { return counted_alloc(size, static_cast<size_t>(al)); }
+
+void operator delete(void* p) noexcept { counted_free(p); }
+void operator delete[](void* p) noexcept { counted_free(p); }
+void operator delete(void* p, size_t) noexcept { counted_free(p); }
+void operator delete[](void* p, size_t) noexcept { counted_free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { counted_free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { counted_free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { counted_free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { counted_free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { counted_free(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { counted_free(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { counted_free(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { counted_free(p); }
+
+// ---------------------------------------------------------------------------
+// Benchmarks
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Current and peak resident set size in bytes (0 when unknown)
+ */
+std::pair<size_t, size_t> resident_set() {
+    size_t current = 0, peak = 0;
+#if defined(__linux__)
+    std::ifstream status("/proc/self/status");
+    std::string key;
+    size_t kb = 0;
+    std::string unit;
+    while (status >> key) {
+        if (key == "VmRSS:" && status >> kb >> unit) {
+            current = kb * 1024;
+        } else if (key == "VmHWM:" && status >> kb >> unit) {
+            peak = kb * 1024;
+        }
+    }
+#elif defined(__APPLE__)
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    peak = static_cast<size_t>(usage.ru_maxrss);  // bytes on macOS
+#endif
+    return {current, peak};
+}
+
+/**
+ * @brief Allocation cost of one submission API
+ */
+struct AllocResult {
+    std::string api;
+    size_t tasks;
+    double allocs_per_task;
+    double bytes_per_task;
+    double mallocs_per_task;
+};
+
+template<typename Run>
+AllocResult measure(const std::string& api, size_t tasks, Run&& run) {
+    auto before = counters::Snapshot::now();
+    run();
+    auto after = counters::Snapshot::now();
+    
+    double n = static_cast<double>(tasks);
+    return {
+        api,
+        tasks,
+        static_cast<double>(after.allocations - before.allocations) / n,
+        static_cast<double>(after.bytes - before.bytes) / n,
+        static_cast<double>(after.malloc_calls - before.malloc_calls) / n
+    };
+}
+
+void print_results(const std::vector<AllocResult>& results) {
+    std::cout << std::left << std::setw(36) << "API"
+              << std::right << std::setw(10) << "Tasks"
+              << std::setw(14) << "Allocs/task"
+              << std::setw(14) << "Bytes/task"
+#if defined(BENCH_COUNT_MALLOC) && defined(__GLIBC__)
+              << std::setw(16) << "Mallocs/task"
+#endif
+              << std::endl;
+    std::cout << std::string(90, '-') << std::endl;
+    for (const auto& r : results) {
+        std::cout << std::left << std::setw(36) << r.api
+                  << std::right << std::setw(10) << r.tasks
+                  << std::fixed << std::setprecision(2)
+                  << std::setw(14) << r.allocs_per_task
+                  << std::setw(14) << r.bytes_per_task
+#if defined(BENCH_COUNT_MALLOC) && defined(__GLIBC__)
+                  << std::setw(16) << r.mallocs_per_task
+#endif
+                  << std::endl;
+    }
+}
+
+/**
+ * @brief Fill the queue while every worker is blocked and report the footprint
+ */
+void queued_footprint(size_t num_threads, size_t queued) {
+    std::cout << "\n--- Footprint with " << queued << " tasks queued ---" << std::endl;
+    
+    auto rss_before = resident_set().first;
+    int64_t live_before = counters::live_bytes.load();
+    
+    {
+        tp::ThreadPool pool(num_threads);
+        std::promise<void> gate;
+        std::shared_future<void> released = gate.get_future().share();
+        for (size_t i = 0; i < pool.size(); ++i) {
+            pool.submit([released] { released.wait(); });
+        }
+        while (pool.active() < pool.size()) {
+            std::this_thread::yield();
+        }
+        
+        counters::peak_live_bytes.store(counters::live_bytes.load());
+        auto start = bench::Clock::now();
+        for (size_t i = 0; i < queued; ++i) {
+            pool.submit([] {});  // Future discarded; the task keeps its shared state alive
+        }
+        double fill_ms = std::chrono::duration<double, std::milli>(bench::Clock::now() - start).count();
+        
+        auto [rss_full, rss_peak] = resident_set();
+        int64_t live_full = counters::live_bytes.load() - live_before;
+        
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << "Fill time:              " << fill_ms << " ms" << std::endl;
+        std::cout << "Live heap bytes:        " << live_full / (1024.0 * 1024.0) << " MiB ("
+                  << static_cast<double>(live_full) / static_cast<double>(queued) << " bytes/task)" << std::endl;
+        if (rss_full > 0) {
+            std::cout << "RSS growth:             " << (static_cast<double>(rss_full) - static_cast<double>(rss_before)) / (1024.0 * 1024.0) 
+                      << " MiB" << std::endl;
+        }
+        if (rss_peak > 0) {
+            std::cout << "Peak RSS (process):     " << static_cast<double>(rss_peak) / (1024.0 * 1024.0) << " MiB" << std::endl;
+        }
+        
+        gate.set_value();
+        pool.wait();
+    }
+    
+    std::cout << "Live heap after drain:  " 
+              << static_cast<double>(counters::live_bytes.load() - live_before) / 1024.0 << " KiB" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    size_t num_threads = bench::arg_value(argc, argv, "threads", std::thread::hardware_concurrency());
+    size_t num_tasks = bench::arg_value(argc, argv, "tasks", 100000);
+    size_t queued = bench::arg_value(argc, argv, "queued", 10000000);
+    
+    std::cout << "=== cpp-threadpool Allocation Benchmark ===" << std::endl;
+    
+    std::vector<AllocResult> results;
+    {
+        tp::ThreadPool pool(num_threads);
+        std::cout << "Thread pool size: " << pool.size() << "\n" << std::endl;
+        
+        std::vector<std::future<void>> futures;
+        std::vector<std::future<int>> int_futures;
+        futures.reserve(num_tasks);
+        int_futures.reserve(num_tasks);
+        
+        // Warm up (thread-local and queue capacity allocations)
+        for (int i = 0; i < 1000; ++i) {
+            pool.submit([] {}).wait();
+        }
+        
+        auto wait_all = [](auto& fs) {
+            for (auto& f : fs) {
+                f.wait();
+            }
+            fs.clear();
+        };
+        
+        results.push_back(measure("submit (empty lambda)", num_tasks, [&] {
+            for (size_t i = 0; i < num_tasks; ++i) {
+                futures.push_back(pool.submit([] {}));
+            }
+            wait_all(futures);
+        }));
+        
+        results.push_back(measure("submit (64-byte capture)", num_tasks, [&] {
+            std::array<char, 64> payload{};
+            for (size_t i = 0; i < num_tasks; ++i) {
+                futures.push_back(pool.submit([payload] { (void)payload; }));
+            }
+            wait_all(futures);
+        }));
+        
+        results.push_back(measure("submit (with args, int result)", num_tasks, [&] {
+            for (size_t i = 0; i < num_tasks; ++i) {
+                int_futures.push_back(pool.submit([](int a, int b) { return a + b; }, 1, 2));
+            }
+            wait_all(int_futures);
+        }));
+        
+        results.push_back(measure("submit_priority", num_tasks, [&] {
+            for (size_t i = 0; i < num_tasks; ++i) {
+                futures.push_back(pool.submit_priority(static_cast<int>(i % 10), [] {}));
+            }
+            wait_all(futures);
+        }));
+        
+        results.push_back(measure("submit_tagged (short tag)", num_tasks, [&] {
+            for (size_t i = 0; i < num_tasks; ++i) {
+                futures.push_back(pool.submit_tagged("io", [] {}));
+            }
+            wait_all(futures);
+        }));
+        
+        results.push_back(measure("submit_tagged (long tag)", num_tasks, [&] {
+            for (size_t i = 0; i < num_tasks; ++i) {
+                futures.push_back(pool.submit_tagged("database-connection-pool", [] {}));
+            }
+            wait_all(futures);
+        }));
+        
+        results.push_back(measure("parallel_for (per index)", num_tasks, [&] {
+            tp::parallel_for(pool, 0, num_tasks, [](size_t) {});
+        }));
+        
+        std::vector<int> input(num_tasks, 1);
+        results.push_back(measure("parallel_map (per element)", num_tasks, [&] {
+            auto out = tp::parallel_map(pool, input, [](int x) { return x + 1; });
+        }));
+    }
+    
+    print_results(results);
+    queued_footprint(num_threads, queued);
+    
+    return 0;
+}
@@ -0,0 +1,149 @@
+/**
+ * @file benchmark_bfs.cpp
+ * @brief Parallel BFS on a large random graph
+ * 
+ * Usage: benchmark_bfs [--vertices N] [--degree N] [--threads N] [--chunk N]
+ * 
+ * Builds a symmetric uniform random graph and traverses it from vertex 0
+ * with a serial queue BFS, top-down parallel_bfs, direction-optimising
+ * parallel_bfs, and the generic hash-set parallel_bfs over the same
+ * adjacency. Reports time, edges examined and MTEPS (edges of the reached
+ * component per second, the Graph500 convention).
+ */
+
+#include "bench_common.hpp"
+
+#include <threadpool/threadpool.hpp>
+#include <threadpool/parallel_bfs.hpp>
+#include <queue>
+#include <random>
+#include <thread>
+
+using bench::Clock;
+
+tp::CsrGraph build_graph(uint32_t vertices, size_t degree) {
+    std::mt19937_64 gen(12345);
+    std::uniform_int_distribution<uint32_t> pick(0, vertices - 1);
+    size_t pairs = static_cast<size_t>(vertices) * degree / 2;
+    
+    std::vector<std::pair<uint32_t, uint32_t>> edges(pairs);
+    std::vector<uint64_t> counts(vertices + 1, 0);
+    for (auto& [a, b] : edges) {
+        a = pick(gen);
+        b = pick(gen);
+        ++counts[a + 1];
+        ++counts[b + 1];
+    }
+    
+    tp::CsrGraph graph;
+    graph.offsets.resize(vertices + 1);
+    for (size_t v = 0; v < vertices; ++v) {
+        counts[v + 1] += counts[v];
+    }
+    graph.offsets.assign(counts.begin(), counts.end());
+    graph.targets.resize(pairs * 2);
+    std::vector<uint64_t> fill(counts.begin(), counts.end() - 1);
+    for (const auto& [a, b] : edges) {
+        graph.targets[fill[a]++] = b;
+        graph.targets[fill[b]++] = a;
+    }
+    return graph;
+}
+
+std::vector<int32_t> serial_bfs(const tp::CsrGraph& graph, uint32_t root, size_t& edges) {
+    std::vector<int32_t> depth(graph.vertices(), -1);
+    std::queue<uint32_t> queue;
+    depth[root] = 0;
+    queue.push(root);
+    edges = 0;
+    while (!queue.empty()) {
+        uint32_t v = queue.front();
+        queue.pop();
+        for (uint64_t e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e) {
+            ++edges;
+            uint32_t u = graph.targets[e];
+            if (depth[u] == -1) {
+                depth[u] = depth[v] + 1;
+                queue.push(u);
+            }
+        }
+    }
+    return depth;
+}
+
+void print_row(const std::string& label, double ms, size_t examined, size_t component_edges, double serial_ms) {
+    std::cout << std::left << std::setw(26) << label
+              << std::right << std::fixed << std::setprecision(1)
+              << std::setw(12) << ms
+              << std::setw(14) << examined
+              << std::setw(10) << static_cast<double>(component_edges) / ms / 1000.0
+              << std::setw(9) << std::setprecision(2) << serial_ms / ms << "x"
+              << std::endl;
+}
+
+int main(int argc, char** argv) {
+    uint32_t vertices = static_cast<uint32_t>(bench::arg_value(argc, argv, "vertices", 1000000));
+    size_t degree = bench::arg_value(argc, argv, "degree", 16);
+    size_t max_threads = bench::arg_value(argc, argv, "threads", 
+                                          std::max<unsigned>(std::thread::hardware_concurrency(), 1));
+    size_t chunk = bench::arg_value(argc, argv, "chunk", 1024);
+    
+    std::cout << "=== cpp-threadpool Parallel BFS ===" << std::endl;
+    auto build_start = Clock::now();
+    tp::CsrGraph graph = build_graph(vertices, degree);
+    std::cout << "Graph: " << graph.vertices() << " vertices, " << graph.edges() 
+              << " directed edges (built in " << std::fixed << std::setprecision(0)
+              << bench::micros(build_start, Clock::now()) / 1000.0 << " ms)" << std::endl;
+    
+    size_t serial_edges = 0;
+    auto start = Clock::now();
+    auto expected = serial_bfs(graph, 0, serial_edges);
+    double serial_ms = bench::micros(start, Clock::now()) / 1000.0;
+    
+    // Edges of the reached component, counted once per direction
+    size_t component_edges = 0;
+    for (size_t v = 0; v < graph.vertices(); ++v) {
+        if (expected[v] >= 0) {
+            component_edges += graph.degree(static_cast<uint32_t>(v));
+        }
+    }
+    
+    std::cout << "\n" << std::left << std::setw(26) << "Variant"
+              << std::right << std::setw(12) << "Time (ms)"
+              << std::setw(14) << "Edges seen"
+              << std::setw(10) << "MTEPS"
+              << std::setw(10) << "Speedup" << std::endl;
+    std::cout << std::string(72, '-') << std::endl;
+    print_row("serial queue", serial_ms, serial_edges, component_edges, serial_ms);
+    
+    for (size_t threads : bench::thread_sweep(max_threads)) {
+        tp::ThreadPool pool(threads);
+        std::string suffix = " (" + std::to_string(threads) + "T)";
+        
+        for (bool direction_optimizing : {false, true}) {
+            tp::BfsOptions options;
+            options.chunk_size = chunk;
+            options.direction_optimizing = direction_optimizing;
+            auto result = tp::parallel_bfs(pool, graph, 0, options);
+            double ms = std::chrono::duration<double, std::milli>(result.stats.elapsed).count();
+            std::string label = (direction_optimizing ? "direction-optimizing" : "top-down") + suffix;
+            if (result.depth != expected) {
+                label += " MISMATCH";
+            }
+            print_row(label, ms, result.stats.edges, component_edges, serial_ms);
+        }
+        
+        tp::BfsOptions options;
+        options.chunk_size = chunk;
+        auto stats = tp::parallel_bfs(pool, std::vector<uint32_t>{0}, 
+            [&graph](uint32_t v, size_t, auto& emit) {
+                for (uint64_t e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e) {
+                    emit(graph.targets[e]);
+                }
+            }, options);
+        double ms = std::chrono::duration<double, std::milli>(stats.elapsed).count();
+        print_row("generic hash-set" + suffix, ms, stats.edges, component_edges, serial_ms);
+    }
+    
+    return 0;
+}
@@ -0,0 +1,260 @@
+/**
+ * @file benchmark_compare.cpp
+ * @brief Identical workloads on tp::ThreadPool and baseline executors
+ * 
+ * Usage: benchmark_compare [--threads N] [--tasks N]
+ * 
+ * Executors: tp::ThreadPool, std::async per task, one std::thread per
+ * static chunk, a naive single-mutex queue pool and (when built with
+ * OpenMP) OpenMP tasks. Latency is submit -> start of each task.
+ */
+
+#include "bench_common.hpp"
+
+#include <threadpool/threadpool.hpp>
+#include <condition_variable>
+#include <functional>
+#include <queue>
+#include <thread>
+
+#if defined(BENCH_HAVE_OPENMP)
+#include <omp.h>
+#endif
+
+using bench::Clock;
+
+/**
+ * @brief Textbook pool: one std::queue guarded by one mutex
+ */
+class NaivePool {
+public:
+    explicit NaivePool(size_t num_threads) {
+        for (size_t i = 0; i < num_threads; ++i) {
+            workers_.emplace_back([this] { run(); });
+        }
+    }
+    
+    ~NaivePool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for (auto& w : workers_) {
+            w.join();
+        }
+    }
+    
+    template<typename F>
+    std::future<void> submit(F&& func) {
+        auto task = std::make_shared<std::packaged_task<void()>>(std::forward<F>(func));
+        auto future = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.emplace([task] { (*task)(); });
+        }
+        cv_.notify_one();
+        return future;
+    }
+
+private:
+    void run() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+                if (queue_.empty()) {
+                    return;
+                }
+                task = std::move(queue_.front());
+                queue_.pop();
+            }
+            task();
+        }
+    }
+    
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::queue<std::function<void()>> queue_;
+    std::vector<std::thread> workers_;
+    bool stop_ = false;
+};
+
+/**
+ * @brief Result of one executor on one workload
+ */
+struct CompareResult {
+    std::string executor;
+    double elapsed_ms = 0.0;
+    double tasks_per_second = 0.0;
+    bench::Percentiles start_latency_us;
+};
+
+/**
+ * @brief Timestamps shared by every executor run
+ */
+struct Workload {
+    size_t num_tasks;
+    std::chrono::nanoseconds work;
+    std::vector<Clock::time_point> submitted;
+    std::vector<Clock::time_point> started;
+    
+    Workload(size_t n, std::chrono::nanoseconds w) 
+        : num_tasks(n), work(w), submitted(n), started(n) {}
+    
+    void run_task(size_t i) {
+        started[i] = Clock::now();
+        bench::spin_for(work);
+    }
+};
+
+/**
+ * @brief Time a run and collect the per-task latencies
+ */
+template<typename Run>
+CompareResult measure(const std::string& executor, Workload& workload, Run&& run) {
+    auto start = Clock::now();
+    run();
+    auto end = Clock::now();
+    
+    std::vector<double> latencies;
+    latencies.reserve(workload.num_tasks);
+    for (size_t i = 0; i < workload.num_tasks; ++i) {
+        latencies.push_back(bench::micros(workload.submitted[i], workload.started[i]));
+    }
+    
+    CompareResult result;
+    result.executor = executor;
+    result.elapsed_ms = std::chrono::duration<double, std::milli>(end - start).count();
+    result.tasks_per_second = workload.num_tasks / result.elapsed_ms * 1000.0;
+    result.start_latency_us = bench::percentiles(std::move(latencies));
+    return result;
+}
+
+std::vector<CompareResult> compare(size_t num_threads, size_t num_tasks, std::chrono::nanoseconds work) {
+    std::vector<CompareResult> results;
+    Workload w(num_tasks, work);
+    
+    {
+        tp::ThreadPool pool(num_threads);
+        results.push_back(measure("tp::ThreadPool", w, [&] {
+            std::vector<std::future<void>> futures;
+            futures.reserve(num_tasks);
+            for (size_t i = 0; i < num_tasks; ++i) {
+                w.submitted[i] = Clock::now();
+                futures.push_back(pool.submit([&w, i] { w.run_task(i); }));
+            }
+            for (auto& f : futures) {
+                f.wait();
+            }
+        }));
+    }
+    
+    {
+        NaivePool pool(num_threads);
+        results.push_back(measure("naive single-mutex pool", w, [&] {
+            std::vector<std::future<void>> futures;
+            futures.reserve(num_tasks);
+            for (size_t i = 0; i < num_tasks; ++i) {
+                w.submitted[i] = Clock::now();
+                futures.push_back(pool.submit([&w, i] { w.run_task(i); }));
+            }
+            for (auto& f : futures) {
+                f.wait();
+            }
+        }));
+    }
+    
+    results.push_back(measure("std::thread per chunk", w, [&] {
+        auto now = Clock::now();
+        std::fill(w.submitted.begin(), w.submitted.end(), now);
+        std::vector<std::thread> threads;
+        size_t chunk = (num_tasks + num_threads - 1) / num_threads;
+        for (size_t begin = 0; begin < num_tasks; begin += chunk) {
+            size_t end = std::min(begin + chunk, num_tasks);
+            threads.emplace_back([&w, begin, end] {
+                for (size_t i = begin; i < end; ++i) {
+                    w.run_task(i);
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+    }));
+    
+    results.push_back(measure("std::async per task", w, [&] {
+        std::vector<std::future<void>> futures;
+        futures.reserve(num_tasks);
+        for (size_t i = 0; i < num_tasks; ++i) {
+            w.submitted[i] = Clock::now();
+            futures.push_back(std::async(std::launch::async, [&w, i] { w.run_task(i); }));
+        }
+        for (auto& f : futures) {
+            f.wait();
+        }
+    }));
+    
+#if defined(BENCH_HAVE_OPENMP)
+    results.push_back(measure("OpenMP tasks", w, [&] {
+        #pragma omp parallel num_threads(static_cast<int>(num_threads))
+        {
+            #pragma omp single
+            {
+                for (size_t i = 0; i < num_tasks; ++i) {
+                    w.submitted[i] = Clock::now();
+                    #pragma omp task firstprivate(i) shared(w)
+                    w.run_task(i);
+                }
+                #pragma omp taskwait
+            }
+        }
+    }));
+#endif
+    
+    return results;
+}
+
+void print_comparison(const std::string& title, const std::vector<CompareResult>& results) {
+    std::cout << "\n--- " << title << " ---" << std::endl;
+    std::cout << std::left << std::setw(28) << "Executor"
+              << std::right << std::setw(12) << "Time (ms)"
+              << std::setw(16) << "Tasks/sec"
+              << std::setw(12) << "vs pool"
+              << std::setw(14) << "p50 start us"
+              << std::setw(14) << "p99 start us"
+              << std::endl;
+    std::cout << std::string(96, '-') << std::endl;
+    
+    double baseline = results.front().tasks_per_second;
+    for (const auto& r : results) {
+        std::cout << std::left << std::setw(28) << r.executor
+                  << std::right << std::fixed
+                  << std::setw(12) << std::setprecision(2) << r.elapsed_ms
+                  << std::setw(16) << std::setprecision(0) << r.tasks_per_second
+                  << std::setw(11) << std::setprecision(2) << r.tasks_per_second / baseline << "x"
+                  << std::setw(14) << r.start_latency_us.p50
+                  << std::setw(14) << r.start_latency_us.p99
+                  << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t num_threads = bench::arg_value(argc, argv, "threads", std::thread::hardware_concurrency());
+    size_t num_tasks = bench::arg_value(argc, argv, "tasks", 20000);
+    num_threads = std::max<size_t>(num_threads, 1);
+    
+    std::cout << "=== cpp-threadpool Executor Comparison ===" << std::endl;
+    std::cout << "Threads: " << num_threads << ", tasks per workload: " << num_tasks << std::endl;
+#if !defined(BENCH_HAVE_OPENMP)
+    std::cout << "(OpenMP not available, skipping OpenMP tasks)" << std::endl;
+#endif
+    
+    for (auto work_ns : {0, 1000, 10000}) {
+        auto results = compare(num_threads, num_tasks, std::chrono::nanoseconds(work_ns));
+        print_comparison("Task work " + std::to_string(work_ns) + " ns", results);
+    }
+    
+    return 0;
+}
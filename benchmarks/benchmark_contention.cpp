@@ -0,0 +1,186 @@
+/**
+ * @file benchmark_contention.cpp
+ * @brief Submission contention: many producers, worker submits, hot producer
+ * 
+ * Usage: benchmark_contention [--threads N] [--tasks N] [--max-producers N]
+ * 
+ * Every pool is built with PoolConfig::instrument_locks so each row also
+ * reports how often the queue locks were contended.
+ */
+
+#include "bench_common.hpp"
+
+#include <threadpool/threadpool.hpp>
+#include <atomic>
+#include <thread>
+
+using bench::Clock;
+
+/**
+ * @brief Throughput and lock behaviour of one scenario
+ */
+struct ContentionResult {
+    std::string scenario;
+    size_t producers = 0;
+    size_t tasks = 0;
+    double ops_per_second = 0.0;
+    tp::LockStats global_lock;
+    tp::LockStats local_locks;
+    size_t steals = 0;
+};
+
+tp::PoolConfig instrumented_config(size_t num_threads) {
+    tp::PoolConfig config;
+    config.num_threads = num_threads;
+    config.instrument_locks = true;
+    return config;
+}
+
+void wait_countdown(const std::atomic<size_t>& remaining) {
+    while (remaining.load(std::memory_order_acquire) > 0) {
+        std::this_thread::yield();
+    }
+}
+
+ContentionResult collect(const std::string& scenario, size_t producers, size_t tasks,
+                         Clock::duration elapsed, const tp::ThreadPool& pool) {
+    auto stats = pool.stats();
+    
+    ContentionResult result;
+    result.scenario = scenario;
+    result.producers = producers;
+    result.tasks = tasks;
+    result.ops_per_second = tasks / std::chrono::duration<double>(elapsed).count();
+    result.global_lock = stats.global_queue_lock;
+    for (const auto& l : stats.local_queue_locks) {
+        result.local_locks.acquisitions += l.acquisitions;
+        result.local_locks.contended += l.contended;
+        result.local_locks.wait_time += l.wait_time;
+    }
+    result.steals = stats.total_tasks_stolen;
+    return result;
+}
+
+/**
+ * @brief N external threads submitting empty tasks concurrently
+ */
+ContentionResult external_producers(size_t num_threads, size_t producers, size_t total_tasks) {
+    tp::ThreadPool pool(instrumented_config(num_threads));
+    size_t per_producer = std::max<size_t>(total_tasks / producers, 1);
+    std::atomic<size_t> remaining{per_producer * producers};
+    std::atomic<bool> go{false};
+    
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&] {
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            for (size_t i = 0; i < per_producer; ++i) {
+                pool.submit([&remaining] { remaining.fetch_sub(1, std::memory_order_release); });
+            }
+        });
+    }
+    
+    auto start = Clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& t : threads) {
+        t.join();
+    }
+    wait_countdown(remaining);
+    auto elapsed = Clock::now() - start;
+    
+    return collect("external producers", producers, per_producer * producers, elapsed, pool);
+}
+
+/**
+ * @brief Seed tasks that each submit a batch of children from inside the pool
+ */
+ContentionResult worker_submits(size_t num_threads, size_t total_tasks) {
+    tp::ThreadPool pool(instrumented_config(num_threads));
+    size_t seeds = pool.size() * 4;
+    size_t children = std::max<size_t>(total_tasks / seeds, 1);
+    std::atomic<size_t> remaining{seeds * children};
+    
+    auto start = Clock::now();
+    for (size_t s = 0; s < seeds; ++s) {
+        pool.submit([&pool, &remaining, children] {
+            for (size_t i = 0; i < children; ++i) {
+                pool.submit([&remaining] { remaining.fetch_sub(1, std::memory_order_release); });
+            }
+        });
+    }
+    wait_countdown(remaining);
+    auto elapsed = Clock::now() - start;
+    
+    return collect("submits from workers", seeds, seeds * children, elapsed, pool);
+}
+
+/**
+ * @brief One worker filling its own deque while every other worker steals
+ */
+ContentionResult hot_producer(size_t num_threads, size_t total_tasks) {
+    tp::ThreadPool pool(instrumented_config(num_threads));
+    std::atomic<size_t> remaining{total_tasks};
+    
+    auto start = Clock::now();
+    pool.submit([&pool, &remaining, total_tasks] {
+        for (size_t i = 0; i < total_tasks; ++i) {
+            pool.submit([&remaining] { remaining.fetch_sub(1, std::memory_order_release); });
+        }
+    });
+    wait_countdown(remaining);
+    auto elapsed = Clock::now() - start;
+    
+    return collect("hot producer, " + std::to_string(pool.size() - 1) + " thieves", 1, total_tasks, elapsed, pool);
+}
+
+void print_header() {
+    std::cout << std::left << std::setw(30) << "Scenario"
+              << std::right << std::setw(10) << "Producers"
+              << std::setw(12) << "Ops/sec"
+              << std::setw(14) << "Global acq"
+              << std::setw(11) << "Contended"
+              << std::setw(12) << "Wait (ms)"
+              << std::setw(14) << "Local acq"
+              << std::setw(11) << "Contended"
+              << std::setw(9) << "Steals"
+              << std::endl;
+    std::cout << std::string(123, '-') << std::endl;
+}
+
+void print_row(const ContentionResult& r) {
+    auto wait_ms = [](const tp::LockStats& l) {
+        return std::chrono::duration<double, std::milli>(l.wait_time).count();
+    };
+    std::cout << std::left << std::setw(30) << r.scenario
+              << std::right << std::setw(10) << r.producers
+              << std::fixed << std::setprecision(0) << std::setw(12) << r.ops_per_second
+              << std::setw(14) << r.global_lock.acquisitions
+              << std::setprecision(1) << std::setw(10) << r.global_lock.contention_rate() * 100.0 << "%"
+              << std::setprecision(2) << std::setw(12) << wait_ms(r.global_lock) + wait_ms(r.local_locks)
+              << std::setw(14) << r.local_locks.acquisitions
+              << std::setprecision(1) << std::setw(10) << r.local_locks.contention_rate() * 100.0 << "%"
+              << std::setw(9) << r.steals
+              << std::endl;
+}
+
+int main(int argc, char** argv) {
+    size_t num_threads = bench::arg_value(argc, argv, "threads", std::thread::hardware_concurrency());
+    size_t num_tasks = bench::arg_value(argc, argv, "tasks", 200000);
+    size_t max_producers = bench::arg_value(argc, argv, "max-producers", 128);
+    num_threads = std::max<size_t>(num_threads, 1);
+    
+    std::cout << "=== cpp-threadpool Contention Benchmark ===" << std::endl;
+    std::cout << "Workers: " << num_threads << ", tasks per scenario: " << num_tasks << std::endl;
+    std::cout << "(Wait column is total slow-path lock wait across global and local queues)\n" << std::endl;
+    
+    print_header();
+    for (size_t producers = 1; producers <= max_producers; producers *= 2) {
+        print_row(external_producers(num_threads, producers, num_tasks));
+    }
+    print_row(worker_submits(num_threads, num_tasks));
+    print_row(hot_producer(num_threads * 2, num_tasks));
+    
+    return 0;
+}
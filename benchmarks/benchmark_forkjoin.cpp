@@ -0,0 +1,279 @@
+/**
+ * @file benchmark_forkjoin.cpp
+ * @brief Recursive fork-join benchmarks: Fibonacci, N-Queens, UTS, quicksort
+ * 
+ * Usage: benchmark_forkjoin [--max-threads N] [--fib N] [--queens N]
+ *                           [--uts-root N] [--uts-seed N] [--sort-size N]
+ * 
+ * Each benchmark reports speedup over its serial version together with the
+ * number of tasks submitted and stolen at every thread count. Parents wait
+ * for children with ThreadPool::wait_helping so nested waits cannot starve
+ * the pool.
+ */
+
+#include "bench_common.hpp"
+
+#include <threadpool/threadpool.hpp>
+#include <functional>
+#include <random>
+#include <thread>
+
+using bench::Clock;
+
+// ---------------------------------------------------------------------------
+// Fibonacci with serial cutoff
+// ---------------------------------------------------------------------------
+
+uint64_t fib_serial(int n) {
+    return n < 2 ? static_cast<uint64_t>(n) : fib_serial(n - 1) + fib_serial(n - 2);
+}
+
+uint64_t fib_parallel(tp::ThreadPool& pool, int n, int cutoff) {
+    if (n < cutoff) {
+        return fib_serial(n);
+    }
+    auto left = pool.submit(fib_parallel, std::ref(pool), n - 1, cutoff);
+    uint64_t right = fib_parallel(pool, n - 2, cutoff);
+    pool.wait_helping(left);
+    return left.get() + right;
+}
+
+// ---------------------------------------------------------------------------
+// N-Queens (bitmask), parallel over the first rows
+// ---------------------------------------------------------------------------
+
+uint64_t queens_serial(int n, int row, uint32_t cols, uint32_t diag1, uint32_t diag2) {
+    if (row == n) {
+        return 1;
+    }
+    uint64_t count = 0;
+    uint32_t available = ~(cols | diag1 | diag2) & ((1u << n) - 1);
+    while (available) {
+        uint32_t bit = available & (~available + 1);
+        available ^= bit;
+        count += queens_serial(n, row + 1, cols | bit, (diag1 | bit) << 1, (diag2 | bit) >> 1);
+    }
+    return count;
+}
+
+uint64_t queens_parallel(tp::ThreadPool& pool, int n, int row, uint32_t cols, 
+                         uint32_t diag1, uint32_t diag2, int spawn_rows) {
+    if (row >= spawn_rows) {
+        return queens_serial(n, row, cols, diag1, diag2);
+    }
+    std::vector<std::future<uint64_t>> children;
+    uint32_t available = ~(cols | diag1 | diag2) & ((1u << n) - 1);
+    while (available) {
+        uint32_t bit = available & (~available + 1);
+        available ^= bit;
+        children.push_back(pool.submit(queens_parallel, std::ref(pool), n, row + 1, cols | bit,
+                                       (diag1 | bit) << 1, (diag2 | bit) >> 1, spawn_rows));
+    }
+    uint64_t count = 0;
+    for (auto& child : children) {
+        pool.wait_helping(child);
+        count += child.get();
+    }
+    return count;
+}
+
+// ---------------------------------------------------------------------------
+// Unbalanced Tree Search (binomial tree, hash-derived child counts)
+// ---------------------------------------------------------------------------
+
+struct UtsParams {
+    int root_children = 2000;
+    int m = 8;              // Children of a non-leaf node
+    double q = 0.124875;    // Probability that a node is not a leaf (q*m < 1)
+    int spawn_depth = 3;    // Nodes above this depth are spawned as tasks
+    uint64_t seed = 37;     // Root state; 37 gives a ~3.6M node tree
+};
+
+uint64_t uts_hash(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+int uts_children(const UtsParams& params, uint64_t state, int depth) {
+    if (depth == 0) {
+        return params.root_children;
+    }
+    double u = static_cast<double>(state >> 11) * (1.0 / 9007199254740992.0);
+    return u < params.q ? params.m : 0;
+}
+
+uint64_t uts_child_state(uint64_t state, int index) {
+    return uts_hash(state ^ (static_cast<uint64_t>(index + 1) * 0xd1b54a32d192ed03ULL));
+}
+
+uint64_t uts_serial(const UtsParams& params, uint64_t root_state, int root_depth) {
+    // Explicit stack: near-critical binomial trees can get very deep
+    std::vector<std::pair<uint64_t, int>> stack{{root_state, root_depth}};
+    uint64_t nodes = 0;
+    while (!stack.empty()) {
+        auto [state, depth] = stack.back();
+        stack.pop_back();
+        ++nodes;
+        int children = uts_children(params, state, depth);
+        for (int i = 0; i < children; ++i) {
+            stack.emplace_back(uts_child_state(state, i), depth + 1);
+        }
+    }
+    return nodes;
+}
+
+uint64_t uts_parallel(tp::ThreadPool& pool, const UtsParams& params, uint64_t state, int depth) {
+    if (depth >= params.spawn_depth) {
+        return uts_serial(params, state, depth);
+    }
+    int children = uts_children(params, state, depth);
+    std::vector<std::future<uint64_t>> futures;
+    futures.reserve(static_cast<size_t>(children));
+    for (int i = 0; i < children; ++i) {
+        futures.push_back(pool.submit(uts_parallel, std::ref(pool), std::cref(params), 
+                                      uts_child_state(state, i), depth + 1));
+    }
+    uint64_t nodes = 1;
+    for (auto& f : futures) {
+        pool.wait_helping(f);
+        nodes += f.get();
+    }
+    return nodes;
+}
+
+// ---------------------------------------------------------------------------
+// Parallel quicksort
+// ---------------------------------------------------------------------------
+
+void quicksort_parallel(tp::ThreadPool& pool, int* first, int* last, ptrdiff_t cutoff) {
+    if (last - first < cutoff) {
+        std::sort(first, last);
+        return;
+    }
+    
+    int a = *first, b = first[(last - first) / 2], c = *(last - 1);
+    int pivot = std::max(std::min(a, b), std::min(std::max(a, b), c));
+    
+    int* mid1 = std::partition(first, last, [pivot](int x) { return x < pivot; });
+    int* mid2 = std::partition(mid1, last, [pivot](int x) { return !(pivot < x); });
+    
+    auto left = pool.submit(quicksort_parallel, std::ref(pool), first, mid1, cutoff);
+    quicksort_parallel(pool, mid2, last, cutoff);
+    pool.wait_helping(left);
+}
+
+// ---------------------------------------------------------------------------
+// Driver
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief A fork-join benchmark with a checksum-producing serial reference
+ */
+struct ForkJoinBenchmark {
+    std::string name;
+    std::function<uint64_t()> serial;
+    std::function<uint64_t(tp::ThreadPool&)> parallel;
+};
+
+template<typename F>
+double time_ms(F&& func, uint64_t& checksum) {
+    auto start = Clock::now();
+    checksum = func();
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void run(const ForkJoinBenchmark& b, const std::vector<size_t>& thread_counts) {
+    uint64_t expected = 0;
+    double serial_ms = time_ms(b.serial, expected);
+    
+    std::cout << "\n--- " << b.name << " (serial " << std::fixed << std::setprecision(2) 
+              << serial_ms << " ms, result " << expected << ") ---" << std::endl;
+    std::cout << std::right << std::setw(8) << "Threads"
+              << std::setw(14) << "Time (ms)"
+              << std::setw(10) << "Speedup"
+              << std::setw(12) << "Efficiency"
+              << std::setw(12) << "Tasks"
+              << std::setw(10) << "Steals"
+              << std::setw(8) << "Check"
+              << std::endl;
+    std::cout << std::string(74, '-') << std::endl;
+    
+    for (size_t threads : thread_counts) {
+        tp::ThreadPool pool(threads);
+        uint64_t result = 0;
+        double ms = time_ms([&] { return b.parallel(pool); }, result);
+        auto stats = pool.stats();
+        double speedup = serial_ms / ms;
+        
+        std::cout << std::setw(8) << threads
+                  << std::setw(14) << std::setprecision(2) << ms
+                  << std::setw(9) << speedup << "x"
+                  << std::setw(11) << std::setprecision(1) << speedup / threads * 100.0 << "%"
+                  << std::setw(12) << stats.total_tasks_submitted
+                  << std::setw(10) << stats.total_tasks_stolen
+                  << std::setw(8) << (result == expected ? "ok" : "FAIL")
+                  << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t max_threads = bench::arg_value(argc, argv, "max-threads", std::thread::hardware_concurrency());
+    int fib_n = static_cast<int>(bench::arg_value(argc, argv, "fib", 38));
+    int queens_n = static_cast<int>(bench::arg_value(argc, argv, "queens", 14));
+    size_t sort_size = bench::arg_value(argc, argv, "sort-size", 10000000);
+    
+    UtsParams uts;
+    uts.root_children = static_cast<int>(bench::arg_value(argc, argv, "uts-root", 2000));
+    uts.seed = bench::arg_value(argc, argv, "uts-seed", 37);
+    
+    std::cout << "=== cpp-threadpool Fork-Join Benchmarks ===" << std::endl;
+    auto thread_counts = bench::thread_sweep(max_threads);
+    
+    std::vector<int> sort_input(sort_size);
+    std::mt19937 gen(42);
+    for (auto& v : sort_input) {
+        v = static_cast<int>(gen());
+    }
+    auto sorted_checksum = [](const std::vector<int>& v) -> uint64_t {
+        return std::is_sorted(v.begin(), v.end()) ? v.size() : 0;
+    };
+    
+    std::vector<ForkJoinBenchmark> benchmarks = {
+        {
+            "fib(" + std::to_string(fib_n) + "), cutoff 20",
+            [=] { return fib_serial(fib_n); },
+            [=](tp::ThreadPool& pool) { return fib_parallel(pool, fib_n, 20); }
+        },
+        {
+            std::to_string(queens_n) + "-Queens, spawn 3 rows",
+            [=] { return queens_serial(queens_n, 0, 0, 0, 0); },
+            [=](tp::ThreadPool& pool) { return queens_parallel(pool, queens_n, 0, 0, 0, 0, 3); }
+        },
+        {
+            "UTS binomial (b0=" + std::to_string(uts.root_children) + ", m=8, q=0.124875)",
+            [=] { return uts_serial(uts, uts.seed, 0); },
+            [=](tp::ThreadPool& pool) { return uts_parallel(pool, uts, uts.seed, 0); }
+        },
+        {
+            "quicksort " + std::to_string(sort_size) + " ints, cutoff 10000",
+            [&] {
+                auto data = sort_input;
+                std::sort(data.begin(), data.end());
+                return sorted_checksum(data);
+            },
+            [&](tp::ThreadPool& pool) {
+                auto data = sort_input;
+                quicksort_parallel(pool, data.data(), data.data() + data.size(), 10000);
+                return sorted_checksum(data);
+            }
+        }
+    };
+    
+    for (const auto& b : benchmarks) {
+        run(b, thread_counts);
+    }
+    
+    return 0;
+}
@@ -0,0 +1,345 @@
+/**
+ * @file benchmark_kernels.cpp
+ * @brief Memory-bound and cache-sensitive compute kernels on parallel_for
+ * 
+ * Usage: benchmark_kernels [--threads N] [--reps N] [--gemm-n N] [--grid-n N]
+ *                          [--spmv-rows N] [--hist-n N] [--chunks-per-thread N]
+ * 
+ * Unlike the sin/cos loops in benchmark.cpp these kernels move real data:
+ * blocked GEMM (cache reuse), 2D Jacobi (bandwidth, one barrier per sweep),
+ * CSR SpMV (irregular gathers) and histogramming (private vs shared atomic
+ * bins). Each kernel is split into chunks, parallel_for runs one task per
+ * chunk, and the result is checked against a serial run.
+ */
+
+#include "bench_common.hpp"
+
+#include <threadpool/threadpool.hpp>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <random>
+#include <thread>
+
+using bench::Clock;
+
+/**
+ * @brief Split [0, n) into roughly equal chunks and run body(begin, end) per chunk
+ */
+template<typename Body>
+void chunked_for(tp::ThreadPool& pool, size_t n, size_t chunks, Body& body) {
+    chunks = std::max<size_t>(std::min(chunks, n), 1);
+    auto run_chunk = [&](size_t c) {
+        body(n * c / chunks, n * (c + 1) / chunks);
+    };
+    tp::parallel_for(pool, 0, chunks, run_chunk);
+}
+
+/**
+ * @brief One kernel: prepare data once, run serially or on a pool, verify
+ */
+struct Kernel {
+    std::string name;
+    std::string unit;         // "GFLOP/s" or "GB/s"
+    double work_per_run;      // FLOPs or bytes moved per run
+    std::function<void()> reset;
+    std::function<void(tp::ThreadPool*, size_t)> run;  // nullptr pool = serial
+    std::function<double()> checksum;
+};
+
+// ---------------------------------------------------------------------------
+// Blocked GEMM: C = A * B, row blocks of C are the parallel unit
+// ---------------------------------------------------------------------------
+
+Kernel make_gemm(size_t n) {
+    constexpr size_t kBlock = 64;
+    auto a = std::make_shared<std::vector<double>>(n * n);
+    auto b = std::make_shared<std::vector<double>>(n * n);
+    auto c = std::make_shared<std::vector<double>>(n * n);
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    for (auto& v : *a) v = dist(gen);
+    for (auto& v : *b) v = dist(gen);
+    
+    auto rows = [a, b, c, n](size_t row_begin, size_t row_end) {
+        const double* A = a->data();
+        const double* B = b->data();
+        double* C = c->data();
+        for (size_t kk = 0; kk < n; kk += kBlock) {
+            size_t k_end = std::min(kk + kBlock, n);
+            for (size_t jj = 0; jj < n; jj += kBlock) {
+                size_t j_end = std::min(jj + kBlock, n);
+                for (size_t i = row_begin; i < row_end; ++i) {
+                    for (size_t k = kk; k < k_end; ++k) {
+                        double aik = A[i * n + k];
+                        for (size_t j = jj; j < j_end; ++j) {
+                            C[i * n + j] += aik * B[k * n + j];
+                        }
+                    }
+                }
+            }
+        }
+    };
+    
+    Kernel kernel;
+    kernel.name = "GEMM " + std::to_string(n) + "x" + std::to_string(n);
+    kernel.unit = "GFLOP/s";
+    kernel.work_per_run = 2.0 * static_cast<double>(n) * static_cast<double>(n) * static_cast<double>(n);
+    kernel.reset = [c] { std::fill(c->begin(), c->end(), 0.0); };
+    kernel.run = [rows, n](tp::ThreadPool* pool, size_t chunks) mutable {
+        if (!pool) {
+            rows(0, n);
+            return;
+        }
+        // Chunk boundaries on whole row blocks so each task owns full tiles
+        size_t blocks = (n + kBlock - 1) / kBlock;
+        auto block_rows = [&rows, n](size_t b_begin, size_t b_end) {
+            rows(b_begin * kBlock, std::min(b_end * kBlock, n));
+        };
+        chunked_for(*pool, blocks, chunks, block_rows);
+    };
+    kernel.checksum = [c] { return std::accumulate(c->begin(), c->end(), 0.0); };
+    return kernel;
+}
+
+// ---------------------------------------------------------------------------
+// 2D Jacobi: 5-point stencil, one parallel_for (= one barrier) per sweep
+// ---------------------------------------------------------------------------
+
+Kernel make_jacobi(size_t n, size_t sweeps) {
+    auto src = std::make_shared<std::vector<double>>(n * n);
+    auto dst = std::make_shared<std::vector<double>>(n * n);
+    
+    auto sweep_rows = [n](const double* in, double* out, size_t row_begin, size_t row_end) {
+        for (size_t i = std::max<size_t>(row_begin, 1); i < std::min(row_end, n - 1); ++i) {
+            for (size_t j = 1; j < n - 1; ++j) {
+                out[i * n + j] = 0.25 * (in[(i - 1) * n + j] + in[(i + 1) * n + j]
+                                       + in[i * n + j - 1] + in[i * n + j + 1]);
+            }
+        }
+    };
+    
+    Kernel kernel;
+    kernel.name = "Jacobi " + std::to_string(n) + "^2 x" + std::to_string(sweeps);
+    kernel.unit = "GB/s";
+    // One read stream and one write stream per sweep (neighbours hit cache)
+    kernel.work_per_run = 2.0 * sizeof(double) * static_cast<double>(n) * static_cast<double>(n)
+                        * static_cast<double>(sweeps);
+    kernel.reset = [src, dst, n] {
+        std::fill(src->begin(), src->end(), 0.0);
+        for (size_t j = 0; j < n; ++j) {
+            (*src)[j] = 1.0;  // hot top edge
+        }
+        *dst = *src;
+    };
+    kernel.run = [src, dst, n, sweeps, sweep_rows](tp::ThreadPool* pool, size_t chunks) {
+        for (size_t s = 0; s < sweeps; ++s) {
+            const double* in = src->data();
+            double* out = dst->data();
+            if (!pool) {
+                sweep_rows(in, out, 0, n);
+            } else {
+                auto body = [&](size_t begin, size_t end) { sweep_rows(in, out, begin, end); };
+                chunked_for(*pool, n, chunks, body);
+            }
+            std::swap(*src, *dst);
+        }
+    };
+    kernel.checksum = [src] { return std::accumulate(src->begin(), src->end(), 0.0); };
+    return kernel;
+}
+
+// ---------------------------------------------------------------------------
+// CSR SpMV: y = A * x with random column indices (irregular gathers from x)
+// ---------------------------------------------------------------------------
+
+Kernel make_spmv(size_t rows, size_t nnz_per_row, size_t reps) {
+    auto row_ptr = std::make_shared<std::vector<uint32_t>>(rows + 1);
+    auto cols = std::make_shared<std::vector<uint32_t>>(rows * nnz_per_row);
+    auto vals = std::make_shared<std::vector<double>>(rows * nnz_per_row);
+    auto x = std::make_shared<std::vector<double>>(rows);
+    auto y = std::make_shared<std::vector<double>>(rows);
+    
+    std::mt19937 gen(2);
+    std::uniform_int_distribution<uint32_t> col_dist(0, static_cast<uint32_t>(rows - 1));
+    std::uniform_real_distribution<double> val_dist(-1.0, 1.0);
+    for (size_t r = 0; r < rows; ++r) {
+        (*row_ptr)[r] = static_cast<uint32_t>(r * nnz_per_row);
+        for (size_t k = 0; k < nnz_per_row; ++k) {
+            (*cols)[r * nnz_per_row + k] = col_dist(gen);
+            (*vals)[r * nnz_per_row + k] = val_dist(gen);
+        }
+    }
+    (*row_ptr)[rows] = static_cast<uint32_t>(rows * nnz_per_row);
+    for (auto& v : *x) v = val_dist(gen);
+    
+    auto multiply = [row_ptr, cols, vals, x, y](size_t begin, size_t end) {
+        const uint32_t* rp = row_ptr->data();
+        const uint32_t* ci = cols->data();
+        const double* va = vals->data();
+        const double* xv = x->data();
+        double* yv = y->data();
+        for (size_t r = begin; r < end; ++r) {
+            double sum = 0.0;
+            for (uint32_t k = rp[r]; k < rp[r + 1]; ++k) {
+                sum += va[k] * xv[ci[k]];
+            }
+            yv[r] = sum;
+        }
+    };
+    
+    Kernel kernel;
+    kernel.name = "SpMV " + std::to_string(rows / 1000) + "k rows x" + std::to_string(nnz_per_row);
+    kernel.unit = "GB/s";
+    // Values + column indices + gathered x per nonzero, plus row_ptr and y
+    double nnz = static_cast<double>(rows * nnz_per_row);
+    kernel.work_per_run = static_cast<double>(reps) * (nnz * (sizeof(double) * 2 + sizeof(uint32_t))
+                        + static_cast<double>(rows) * (sizeof(uint32_t) + sizeof(double)));
+    kernel.reset = [y] { std::fill(y->begin(), y->end(), 0.0); };
+    kernel.run = [multiply, rows, reps](tp::ThreadPool* pool, size_t chunks) mutable {
+        for (size_t r = 0; r < reps; ++r) {
+            if (!pool) {
+                multiply(0, rows);
+            } else {
+                chunked_for(*pool, rows, chunks, multiply);
+            }
+        }
+    };
+    kernel.checksum = [y] { return std::accumulate(y->begin(), y->end(), 0.0); };
+    return kernel;
+}
+
+// ---------------------------------------------------------------------------
+// Histogram: per-chunk private bins merged at the end, or shared atomic bins
+// ---------------------------------------------------------------------------
+
+Kernel make_histogram(size_t n, size_t bins, bool shared_atomics) {
+    auto data = std::make_shared<std::vector<uint32_t>>(n);
+    auto result = std::make_shared<std::vector<uint64_t>>(bins);
+    std::mt19937 gen(3);
+    // Skewed input so a few bins are hot, as in real data
+    std::geometric_distribution<uint32_t> dist(0.02);
+    for (auto& v : *data) v = dist(gen) % static_cast<uint32_t>(bins);
+    
+    Kernel kernel;
+    kernel.name = std::string("Histogram ") + (shared_atomics ? "atomic " : "private ")
+                + std::to_string(bins) + " bins";
+    kernel.unit = "GB/s";
+    kernel.work_per_run = static_cast<double>(n * sizeof(uint32_t));
+    kernel.reset = [result] { std::fill(result->begin(), result->end(), 0); };
+    kernel.run = [data, result, bins, n, shared_atomics](tp::ThreadPool* pool, size_t chunks) {
+        const uint32_t* values = data->data();
+        if (!pool) {
+            for (size_t i = 0; i < n; ++i) {
+                ++(*result)[values[i]];
+            }
+            return;
+        }
+        
+        if (shared_atomics) {
+            std::vector<std::atomic<uint64_t>> counts(bins);
+            auto body = [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    counts[values[i]].fetch_add(1, std::memory_order_relaxed);
+                }
+            };
+            chunked_for(*pool, n, chunks, body);
+            for (size_t b = 0; b < bins; ++b) {
+                (*result)[b] = counts[b].load();
+            }
+            return;
+        }
+        
+        chunks = std::max<size_t>(std::min(chunks, n), 1);
+        std::vector<std::vector<uint64_t>> partial(chunks, std::vector<uint64_t>(bins));
+        auto body = [&](size_t c) {
+            auto& local = partial[c];
+            for (size_t i = n * c / chunks; i < n * (c + 1) / chunks; ++i) {
+                ++local[values[i]];
+            }
+        };
+        tp::parallel_for(*pool, 0, chunks, body);
+        for (const auto& local : partial) {
+            for (size_t b = 0; b < bins; ++b) {
+                (*result)[b] += local[b];
+            }
+        }
+    };
+    kernel.checksum = [result] {
+        double weighted = 0.0;
+        for (size_t b = 0; b < result->size(); ++b) {
+            weighted += static_cast<double>((*result)[b]) * static_cast<double>(b + 1);
+        }
+        return weighted;
+    };
+    return kernel;
+}
+
+// ---------------------------------------------------------------------------
+
+double time_run(Kernel& kernel, tp::ThreadPool* pool, size_t chunks, size_t reps) {
+    double best = 1e300;
+    for (size_t r = 0; r < reps; ++r) {
+        kernel.reset();
+        auto start = Clock::now();
+        kernel.run(pool, chunks);
+        best = std::min(best, std::chrono::duration<double>(Clock::now() - start).count());
+    }
+    return best;
+}
+
+int main(int argc, char** argv) {
+    size_t max_threads = bench::arg_value(argc, argv, "threads",
+                                          std::max<unsigned>(std::thread::hardware_concurrency(), 1));
+    size_t reps = std::max<size_t>(bench::arg_value(argc, argv, "reps", 3), 1);
+    size_t gemm_n = bench::arg_value(argc, argv, "gemm-n", 512);
+    size_t grid_n = bench::arg_value(argc, argv, "grid-n", 2048);
+    size_t spmv_rows = bench::arg_value(argc, argv, "spmv-rows", 1000000);
+    size_t hist_n = bench::arg_value(argc, argv, "hist-n", 1 << 24);
+    size_t chunks_per_thread = std::max<size_t>(bench::arg_value(argc, argv, "chunks-per-thread", 4), 1);
+    
+    std::cout << "=== cpp-threadpool Compute Kernels ===" << std::endl;
+    std::cout << "Best of " << reps << " runs, " << chunks_per_thread
+              << " chunks per thread, speedup vs serial" << std::endl;
+    
+    std::vector<Kernel> kernels;
+    kernels.push_back(make_gemm(gemm_n));
+    kernels.push_back(make_jacobi(grid_n, 10));
+    kernels.push_back(make_spmv(spmv_rows, 16, 5));
+    kernels.push_back(make_histogram(hist_n, 256, false));
+    kernels.push_back(make_histogram(hist_n, 256, true));
+    
+    for (auto& kernel : kernels) {
+        double serial = time_run(kernel, nullptr, 1, reps);
+        double expected = kernel.checksum();
+        
+        std::cout << "\n--- " << kernel.name << " ---" << std::endl;
+        std::cout << std::left << std::setw(10) << "Threads"
+                  << std::right << std::setw(12) << "Time (ms)"
+                  << std::setw(12) << kernel.unit
+                  << std::setw(10) << "Speedup"
+                  << std::setw(8) << "Check" << std::endl;
+        std::cout << std::string(52, '-') << std::endl;
+        
+        auto print_row = [&](const std::string& label, double seconds, bool ok) {
+            std::cout << std::left << std::setw(10) << label
+                      << std::right << std::fixed << std::setprecision(2)
+                      << std::setw(12) << seconds * 1000.0
+                      << std::setw(12) << kernel.work_per_run / seconds / 1e9
+                      << std::setw(9) << serial / seconds << "x"
+                      << std::setw(8) << (ok ? "ok" : "FAIL") << std::endl;
+        };
+        print_row("serial", serial, true);
+        
+        for (size_t threads : bench::thread_sweep(max_threads)) {
+            tp::ThreadPool pool(threads);
+            double seconds = time_run(kernel, &pool, threads * chunks_per_thread, reps);
+            double got = kernel.checksum();
+            bool ok = std::abs(got - expected) <= 1e-6 * std::max(1.0, std::abs(expected));
+            print_row(std::to_string(threads), seconds, ok);
+        }
+    }
+    
+    return 0;
+}
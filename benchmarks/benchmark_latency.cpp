@@ -0,0 +1,124 @@
+/**
+ * @file benchmark_latency.cpp
+ * @brief Submit-to-start and end-to-end task latency percentiles
+ * 
+ * Usage: benchmark_latency [--threads N] [--tasks N] [--work-ns N]
+ * 
+ * "complete" is taken at the end of the task body, i.e. just before the
+ * future is made ready.
+ */
+
+#include "bench_common.hpp"
+
+#include <threadpool/threadpool.hpp>
+#include <thread>
+
+using bench::Clock;
+
+/**
+ * @brief How tasks are fed to the pool
+ */
+enum class LoadMode {
+    Idle,       // One task at a time, next submitted once the previous finished
+    Paced,      // Fixed inter-arrival interval well below capacity
+    Saturated,  // Everything submitted at once
+    Parked      // One task at a time after the workers have gone to sleep
+};
+
+/**
+ * @brief Per-task latency samples for one scenario
+ */
+struct LatencyRun {
+    std::string name;
+    std::vector<double> to_start_us;
+    std::vector<double> to_complete_us;
+};
+
+LatencyRun measure(const std::string& name, tp::ThreadPool& pool, LoadMode mode,
+                   size_t num_tasks, std::chrono::nanoseconds work,
+                   std::chrono::nanoseconds interval = std::chrono::nanoseconds{0}) {
+    std::vector<Clock::time_point> submitted(num_tasks);
+    std::vector<Clock::time_point> started(num_tasks);
+    std::vector<Clock::time_point> finished(num_tasks);
+    
+    std::vector<std::future<void>> futures;
+    futures.reserve(num_tasks);
+    
+    auto next_arrival = Clock::now();
+    
+    for (size_t i = 0; i < num_tasks; ++i) {
+        if (mode == LoadMode::Paced) {
+            next_arrival += interval;
+            bench::spin_until(next_arrival);
+        } else if (mode == LoadMode::Parked) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        
+        submitted[i] = Clock::now();
+        futures.push_back(pool.submit([&started, &finished, work, i] {
+            started[i] = Clock::now();
+            bench::spin_for(work);
+            finished[i] = Clock::now();
+        }));
+        
+        if (mode == LoadMode::Idle || mode == LoadMode::Parked) {
+            futures.back().wait();
+        }
+    }
+    
+    for (auto& f : futures) {
+        f.wait();
+    }
+    
+    LatencyRun run;
+    run.name = name;
+    run.to_start_us.reserve(num_tasks);
+    run.to_complete_us.reserve(num_tasks);
+    for (size_t i = 0; i < num_tasks; ++i) {
+        run.to_start_us.push_back(bench::micros(submitted[i], started[i]));
+        run.to_complete_us.push_back(bench::micros(submitted[i], finished[i]));
+    }
+    return run;
+}
+
+int main(int argc, char** argv) {
+    size_t num_threads = bench::arg_value(argc, argv, "threads", std::thread::hardware_concurrency());
+    size_t num_tasks = bench::arg_value(argc, argv, "tasks", 100000);
+    auto work = std::chrono::nanoseconds(bench::arg_value(argc, argv, "work-ns", 1000));
+    
+    std::cout << "=== cpp-threadpool Latency Benchmark ===" << std::endl;
+    
+    tp::ThreadPool pool(num_threads);
+    std::cout << "Thread pool size: " << pool.size() << std::endl;
+    std::cout << "Task work: " << work.count() << " ns" << std::endl;
+    
+    // Warm up
+    for (int i = 0; i < 1000; ++i) {
+        pool.submit([] {}).wait();
+    }
+    
+    // Light load: one arrival per 10x task work per worker (~10% utilisation)
+    auto light_interval = std::max(work * 10 / static_cast<long>(pool.size()), 
+                                   std::chrono::nanoseconds(std::chrono::microseconds(5)));
+    size_t parked_tasks = std::min<size_t>(num_tasks, 500);
+    
+    std::vector<LatencyRun> runs;
+    runs.push_back(measure("idle (one at a time)", pool, LoadMode::Idle, std::min<size_t>(num_tasks, 20000), work));
+    runs.push_back(measure("light load (paced)", pool, LoadMode::Paced, num_tasks, work, light_interval));
+    runs.push_back(measure("saturated (burst)", pool, LoadMode::Saturated, num_tasks, work));
+    runs.push_back(measure("wake from park", pool, LoadMode::Parked, parked_tasks, work));
+    
+    std::cout << "\n--- submit -> start ---" << std::endl;
+    bench::print_percentiles_header("Scenario", "us");
+    for (const auto& run : runs) {
+        bench::print_percentiles(run.name, bench::percentiles(run.to_start_us));
+    }
+    
+    std::cout << "\n--- submit -> complete ---" << std::endl;
+    bench::print_percentiles_header("Scenario", "us");
+    for (const auto& run : runs) {
+        bench::print_percentiles(run.name, bench::percentiles(run.to_complete_us));
+    }
+    
+    return 0;
+}
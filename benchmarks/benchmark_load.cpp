@@ -0,0 +1,206 @@
+/**
+ * @file benchmark_load.cpp
+ * @brief Open-loop load generator: latency percentiles vs offered load
+ * 
+ * Usage: benchmark_load [--threads N] [--duration-ms N] [--service-us N]
+ *                       [--service fixed|exp|bimodal|lognormal]
+ *                       [--arrival poisson|bursty|uniform] [--burst N]
+ * 
+ * Arrivals follow a precomputed schedule and are submitted at their intended
+ * time regardless of how far behind the pool is. Latency is measured from the
+ * intended arrival time, so queueing behind a stalled generator is not hidden
+ * (no coordinated omission). Offered load is relative to the ideal capacity
+ * threads / mean service time.
+ */
+
+#include "bench_common.hpp"
+
+#include <threadpool/threadpool.hpp>
+#include <cmath>
+#include <random>
+#include <thread>
+
+using bench::Clock;
+
+/**
+ * @brief Service time distribution with a given mean
+ */
+class ServiceTime {
+public:
+    ServiceTime(const std::string& kind, double mean_us) : kind_(kind), mean_us_(mean_us) {}
+    
+    std::chrono::nanoseconds sample(std::mt19937_64& gen) const {
+        double us = mean_us_;
+        if (kind_ == "exp") {
+            us = std::exponential_distribution<double>(1.0 / mean_us_)(gen);
+        } else if (kind_ == "bimodal") {
+            // 90% short, 10% long, same mean
+            us = std::bernoulli_distribution(0.1)(gen) ? mean_us_ * 5.5 : mean_us_ * 0.5;
+        } else if (kind_ == "lognormal") {
+            const double sigma = 1.0;
+            double mu = std::log(mean_us_) - sigma * sigma / 2.0;
+            us = std::lognormal_distribution<double>(mu, sigma)(gen);
+        }
+        return std::chrono::nanoseconds(static_cast<int64_t>(us * 1000.0));
+    }
+    
+    double mean_us() const { return mean_us_; }
+    const std::string& kind() const { return kind_; }
+
+private:
+    std::string kind_;
+    double mean_us_;
+};
+
+/**
+ * @brief Build the intended arrival offsets for one load point
+ */
+std::vector<std::chrono::nanoseconds> arrival_schedule(const std::string& kind, double rate_per_sec,
+                                                       std::chrono::milliseconds duration,
+                                                       size_t burst, std::mt19937_64& gen) {
+    std::vector<std::chrono::nanoseconds> arrivals;
+    double mean_gap_ns = 1e9 / rate_per_sec;
+    double limit_ns = std::chrono::duration<double, std::nano>(duration).count();
+    double t = 0.0;
+    
+    std::exponential_distribution<double> exp_gap(1.0 / mean_gap_ns);
+    std::exponential_distribution<double> exp_burst_gap(1.0 / (mean_gap_ns * static_cast<double>(burst)));
+    
+    while (t < limit_ns) {
+        if (kind == "uniform") {
+            arrivals.emplace_back(static_cast<int64_t>(t));
+            t += mean_gap_ns;
+        } else if (kind == "bursty") {
+            // Batches of `burst` simultaneous arrivals, Poisson between batches
+            for (size_t i = 0; i < burst; ++i) {
+                arrivals.emplace_back(static_cast<int64_t>(t));
+            }
+            t += exp_burst_gap(gen);
+        } else {
+            arrivals.emplace_back(static_cast<int64_t>(t));
+            t += exp_gap(gen);
+        }
+    }
+    return arrivals;
+}
+
+/**
+ * @brief Measurements at one offered load
+ */
+struct LoadPoint {
+    double offered_load = 0.0;
+    double offered_rate = 0.0;
+    double achieved_rate = 0.0;
+    bench::Percentiles latency_us;
+    bench::Percentiles queueing_us;
+};
+
+LoadPoint run_load(tp::ThreadPool& pool, double load, const ServiceTime& service,
+                   const std::string& arrival, size_t burst, std::chrono::milliseconds duration) {
+    std::mt19937_64 gen(static_cast<uint64_t>(load * 1000.0) + 1);
+    double capacity = static_cast<double>(pool.size()) * 1e6 / service.mean_us();
+    double rate = load * capacity;
+    
+    auto schedule = arrival_schedule(arrival, rate, duration, burst, gen);
+    size_t n = schedule.size();
+    std::vector<std::chrono::nanoseconds> service_times(n);
+    for (auto& s : service_times) {
+        s = service.sample(gen);
+    }
+    
+    std::vector<Clock::time_point> intended(n), started(n), finished(n);
+    std::vector<std::future<void>> futures;
+    futures.reserve(n);
+    
+    auto origin = Clock::now() + std::chrono::milliseconds(1);
+    for (size_t i = 0; i < n; ++i) {
+        intended[i] = origin + schedule[i];
+        bench::spin_until(intended[i]);
+        futures.push_back(pool.submit([&started, &finished, &service_times, i] {
+            started[i] = Clock::now();
+            bench::spin_for(service_times[i]);
+            finished[i] = Clock::now();
+        }));
+    }
+    for (auto& f : futures) {
+        f.wait();
+    }
+    
+    auto last = *std::max_element(finished.begin(), finished.end());
+    std::vector<double> latency, queueing;
+    latency.reserve(n);
+    queueing.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        latency.push_back(bench::micros(intended[i], finished[i]));
+        queueing.push_back(bench::micros(intended[i], started[i]));
+    }
+    
+    LoadPoint point;
+    point.offered_load = load;
+    point.offered_rate = rate;
+    point.achieved_rate = static_cast<double>(n) / std::chrono::duration<double>(last - origin).count();
+    point.latency_us = bench::percentiles(std::move(latency));
+    point.queueing_us = bench::percentiles(std::move(queueing));
+    return point;
+}
+
+int main(int argc, char** argv) {
+    size_t num_threads = bench::arg_value(argc, argv, "threads", std::thread::hardware_concurrency());
+    auto duration = std::chrono::milliseconds(bench::arg_value(argc, argv, "duration-ms", 1000));
+    double service_us = static_cast<double>(bench::arg_value(argc, argv, "service-us", 50));
+    std::string service_kind = bench::arg_string(argc, argv, "service", "exp");
+    std::string arrival = bench::arg_string(argc, argv, "arrival", "poisson");
+    size_t burst = std::max<size_t>(bench::arg_value(argc, argv, "burst", 16), 1);
+    
+    tp::ThreadPool pool(std::max<size_t>(num_threads, 1));
+    ServiceTime service(service_kind, service_us);
+    
+    std::cout << "=== cpp-threadpool Open-Loop Load Benchmark ===" << std::endl;
+    std::cout << "Workers: " << pool.size() 
+              << ", arrivals: " << arrival << (arrival == "bursty" ? " x" + std::to_string(burst) : "")
+              << ", service: " << service_kind << " mean " << service_us << " us" << std::endl;
+    std::cout << "Latency is intended arrival -> completion; queueing is intended arrival -> start\n" << std::endl;
+    
+    std::cout << std::right << std::setw(6) << "Load"
+              << std::setw(14) << "Offered/s"
+              << std::setw(14) << "Achieved/s"
+              << std::setw(12) << "p50 us"
+              << std::setw(12) << "p99 us"
+              << std::setw(12) << "p999 us"
+              << std::setw(12) << "max us"
+              << std::setw(14) << "p99 queue us"
+              << std::endl;
+    std::cout << std::string(96, '-') << std::endl;
+    
+    double baseline_p99 = 0.0;
+    double knee = 0.0;
+    for (double load : {0.1, 0.3, 0.5, 0.6, 0.7, 0.8, 0.85, 0.9, 0.95, 1.0, 1.1}) {
+        auto p = run_load(pool, load, service, arrival, burst, duration);
+        if (baseline_p99 == 0.0) {
+            baseline_p99 = p.latency_us.p99;
+        }
+        if (knee == 0.0 && (p.latency_us.p99 > 10.0 * baseline_p99 || p.achieved_rate < 0.95 * p.offered_rate)) {
+            knee = load;
+        }
+        
+        std::cout << std::fixed << std::setprecision(2) << std::setw(6) << p.offered_load
+                  << std::setprecision(0) << std::setw(14) << p.offered_rate
+                  << std::setw(14) << p.achieved_rate
+                  << std::setprecision(1)
+                  << std::setw(12) << p.latency_us.p50
+                  << std::setw(12) << p.latency_us.p99
+                  << std::setw(12) << p.latency_us.p999
+                  << std::setw(12) << p.latency_us.max
+                  << std::setw(14) << p.queueing_us.p99
+                  << std::endl;
+    }
+    
+    if (knee > 0.0) {
+        std::cout << "\nSaturation knee at ~" << std::setprecision(2) << knee 
+                  << " of ideal capacity (p99 > 10x low-load p99 or throughput < 95% of offered)" << std::endl;
+    } else {
+        std::cout << "\nNo saturation knee below 1.1x ideal capacity" << std::endl;
+    }
+    
+    return 0;
+}
@@ -0,0 +1,154 @@
+/**
+ * @file benchmark_priority.cpp
+ * @brief High-priority probe latency under a low-priority batch flood
+ * 
+ * Usage: benchmark_priority [--threads N] [--probes N] [--probe-interval-us N]
+ *                           [--batch-us N] [--depth N]
+ * 
+ * A feeder thread keeps about --depth low-priority batch tasks queued while
+ * the main thread injects probe tasks at a fixed rate. Probe latency with and
+ * without a priority advantage shows how much priority scheduling helps and
+ * how much inversion remains (a probe still waits for a running batch task).
+ */
+
+#include "bench_common.hpp"
+
+#include <threadpool/threadpool.hpp>
+#include <atomic>
+#include <thread>
+
+using bench::Clock;
+
+constexpr int kBatchPriority = 10;
+constexpr int kProbePriority = 0;
+
+/**
+ * @brief Probe latencies and batch throughput for one scenario
+ */
+struct InterferenceResult {
+    std::string scenario;
+    bench::Percentiles start_us;
+    bench::Percentiles complete_us;
+    double batch_per_second = 0.0;
+};
+
+struct Settings {
+    size_t threads;
+    size_t probes;
+    std::chrono::microseconds probe_interval;
+    std::chrono::microseconds batch_work;
+    size_t depth;
+};
+
+InterferenceResult run(const std::string& scenario, const Settings& settings, 
+                       bool flood, int probe_priority) {
+    // Declared before the pool: batch tasks still running after shutdown_now()
+    // touch them until the pool's destructor joins the workers
+    std::atomic<bool> stop{false};
+    std::atomic<size_t> batch_done{0};
+    tp::ThreadPool pool(settings.threads);
+    
+    // Keep the queue topped up with batch work
+    std::thread feeder;
+    if (flood) {
+        feeder = std::thread([&] {
+            while (!stop.load(std::memory_order_acquire)) {
+                if (pool.pending() < settings.depth) {
+                    for (int i = 0; i < 64; ++i) {
+                        pool.submit_priority(kBatchPriority, [&batch_done, work = settings.batch_work] {
+                            bench::spin_for(work);
+                            batch_done.fetch_add(1, std::memory_order_relaxed);
+                        });
+                    }
+                } else {
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+                }
+            }
+        });
+        while (pool.pending() < settings.depth / 2) {
+            std::this_thread::yield();
+        }
+    }
+    
+    size_t n = settings.probes;
+    std::vector<Clock::time_point> submitted(n), started(n), finished(n);
+    std::vector<std::future<void>> futures;
+    futures.reserve(n);
+    
+    auto begin = Clock::now();
+    size_t batch_before = batch_done.load();
+    auto next = begin;
+    for (size_t i = 0; i < n; ++i) {
+        next += settings.probe_interval;
+        bench::spin_until(next);
+        submitted[i] = Clock::now();
+        futures.push_back(pool.submit_priority(probe_priority, [&started, &finished, i] {
+            started[i] = Clock::now();
+            finished[i] = Clock::now();
+        }));
+    }
+    for (auto& f : futures) {
+        f.wait();
+    }
+    auto elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+    size_t batch_after = batch_done.load();
+    
+    stop.store(true, std::memory_order_release);
+    if (feeder.joinable()) {
+        feeder.join();
+    }
+    pool.shutdown_now();
+    
+    std::vector<double> to_start, to_complete;
+    for (size_t i = 0; i < n; ++i) {
+        to_start.push_back(bench::micros(submitted[i], started[i]));
+        to_complete.push_back(bench::micros(submitted[i], finished[i]));
+    }
+    
+    InterferenceResult result;
+    result.scenario = scenario;
+    result.start_us = bench::percentiles(std::move(to_start));
+    result.complete_us = bench::percentiles(std::move(to_complete));
+    result.batch_per_second = static_cast<double>(batch_after - batch_before) / elapsed;
+    return result;
+}
+
+int main(int argc, char** argv) {
+    Settings settings;
+    settings.threads = std::max<size_t>(bench::arg_value(argc, argv, "threads", std::thread::hardware_concurrency()), 1);
+    settings.probes = bench::arg_value(argc, argv, "probes", 2000);
+    settings.probe_interval = std::chrono::microseconds(bench::arg_value(argc, argv, "probe-interval-us", 1000));
+    settings.batch_work = std::chrono::microseconds(bench::arg_value(argc, argv, "batch-us", 100));
+    settings.depth = bench::arg_value(argc, argv, "depth", 1000);
+    
+    std::cout << "=== cpp-threadpool Priority Interference Benchmark ===" << std::endl;
+    std::cout << "Workers: " << settings.threads 
+              << ", probes: " << settings.probes << " every " << settings.probe_interval.count() << " us"
+              << ", batch task: " << settings.batch_work.count() << " us, queue depth ~" << settings.depth 
+              << std::endl;
+    
+    std::vector<InterferenceResult> results;
+    results.push_back(run("probes only (no flood)", settings, false, kProbePriority));
+    results.push_back(run("flood, probes same priority", settings, true, kBatchPriority));
+    results.push_back(run("flood, probes high priority", settings, true, kProbePriority));
+    
+    std::cout << "\n--- probe submit -> start ---" << std::endl;
+    bench::print_percentiles_header("Scenario", "us");
+    for (const auto& r : results) {
+        bench::print_percentiles(r.scenario, r.start_us);
+    }
+    
+    std::cout << "\n--- probe submit -> complete ---" << std::endl;
+    bench::print_percentiles_header("Scenario", "us");
+    for (const auto& r : results) {
+        bench::print_percentiles(r.scenario, r.complete_us);
+    }
+    
+    std::cout << "\n--- batch throughput during probing ---" << std::endl;
+    for (const auto& r : results) {
+        std::cout << std::left << std::setw(32) << r.scenario << std::right << std::fixed 
+                  << std::setprecision(0) << std::setw(12) << r.batch_per_second << " tasks/sec" << std::endl;
+    }
+    
+    return 0;
+}
@@ -0,0 +1,262 @@
+/**
+ * @file benchmark_queues.cpp
+ * @brief TaskQueue and WorkStealingDeque driven directly, without a pool
+ * 
+ * Usage: benchmark_queues [--ops N] [--producers N] [--consumers N]
+ *                         [--thieves N] [--payload 8|64|256] [--instrument 1]
+ * 
+ * Without explicit counts a default sweep is run. New queue types plug in by
+ * adding an adapter with push()/try_pop() (and steal() for owner/thief runs).
+ * With --instrument 1 the queues' lock contention counters are reported.
+ */
+
+#include "bench_common.hpp"
+
+#include <threadpool/threadpool.hpp>
+#include <array>
+#include <atomic>
+#include <deque>
+#include <thread>
+
+using bench::Clock;
+
+// ---------------------------------------------------------------------------
+// Queue adapters
+// ---------------------------------------------------------------------------
+
+struct TaskQueueAdapter {
+    static constexpr const char* name = "TaskQueue";
+    tp::TaskQueue queue;
+    
+    void instrument(bool on) { queue.set_lock_instrumentation(on); }
+    tp::LockStats lock_stats() const { return queue.lock_stats(); }
+    void push(tp::Task task) { queue.push(std::move(task)); }
+    std::optional<tp::Task> try_pop() { return queue.try_pop(); }
+};
+
+struct DequeAdapter {
+    static constexpr const char* name = "WorkStealingDeque";
+    tp::WorkStealingDeque deque;
+    
+    void instrument(bool on) { deque.set_lock_instrumentation(on); }
+    tp::LockStats lock_stats() const { return deque.lock_stats(); }
+    void push(tp::Task task) { deque.push_front(std::move(task)); }
+    std::optional<tp::Task> try_pop() { return deque.pop_front(); }
+    std::optional<tp::Task> steal() { return deque.steal(); }
+};
+
+/**
+ * @brief Reference point: std::deque behind a plain std::mutex
+ */
+struct MutexDequeAdapter {
+    static constexpr const char* name = "std::deque + std::mutex";
+    std::mutex mutex;
+    std::deque<tp::Task> deque;
+    
+    void instrument(bool) {}
+    tp::LockStats lock_stats() const { return {}; }
+    void push(tp::Task task) {
+        std::lock_guard<std::mutex> lock(mutex);
+        deque.push_back(std::move(task));
+    }
+    std::optional<tp::Task> try_pop() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (deque.empty()) {
+            return std::nullopt;
+        }
+        tp::Task task = std::move(deque.front());
+        deque.pop_front();
+        return task;
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Drivers
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Cost of one configuration
+ */
+struct QueueResult {
+    std::string queue;
+    std::string pattern;
+    size_t payload;
+    size_t ops;
+    double ns_per_op;
+    double mops_per_sec;
+    tp::LockStats locks;
+};
+
+template<size_t Payload>
+tp::Task make_task(size_t i) {
+    std::array<char, Payload> data{};
+    data[0] = static_cast<char>(i);
+    return tp::Task([data] { (void)data; }, static_cast<int>(i % 4));
+}
+
+QueueResult finish(const std::string& queue, const std::string& pattern, size_t payload,
+                   size_t ops, Clock::duration elapsed, tp::LockStats locks) {
+    double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+    return {queue, pattern, payload, ops, ns / static_cast<double>(ops), 
+            static_cast<double>(ops) / ns * 1000.0, locks};
+}
+
+/**
+ * @brief P producers push, C consumers pop; every item is pushed and popped once
+ */
+template<typename Adapter, size_t Payload>
+QueueResult mpmc(size_t items, size_t producers, size_t consumers, bool instrument) {
+    Adapter q;
+    q.instrument(instrument);
+    size_t per_producer = std::max<size_t>(items / producers, 1);
+    size_t total = per_producer * producers;
+    std::atomic<size_t> consumed{0};
+    std::atomic<bool> go{false};
+    
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            while (!go.load(std::memory_order_acquire)) {}
+            for (size_t i = 0; i < per_producer; ++i) {
+                q.push(make_task<Payload>(p * per_producer + i));
+            }
+        });
+    }
+    for (size_t c = 0; c < consumers; ++c) {
+        threads.emplace_back([&] {
+            while (!go.load(std::memory_order_acquire)) {}
+            while (consumed.load(std::memory_order_relaxed) < total) {
+                if (q.try_pop()) {
+                    consumed.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+    
+    auto start = Clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& t : threads) {
+        t.join();
+    }
+    auto elapsed = Clock::now() - start;
+    
+    std::string pattern = std::to_string(producers) + "P/" + std::to_string(consumers) + "C";
+    return finish(Adapter::name, pattern, Payload, total * 2, elapsed, q.lock_stats());
+}
+
+/**
+ * @brief One owner pushing/popping LIFO while T thieves steal from the other end
+ */
+template<typename Adapter, size_t Payload>
+QueueResult owner_thieves(size_t items, size_t thieves, bool instrument) {
+    Adapter q;
+    q.instrument(instrument);
+    std::atomic<size_t> taken{0};
+    std::atomic<bool> go{false};
+    std::atomic<size_t> stolen{0};
+    
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < thieves; ++t) {
+        threads.emplace_back([&] {
+            while (!go.load(std::memory_order_acquire)) {}
+            while (taken.load(std::memory_order_relaxed) < items) {
+                if (q.steal()) {
+                    taken.fetch_add(1, std::memory_order_relaxed);
+                    stolen.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+    
+    auto start = Clock::now();
+    go.store(true, std::memory_order_release);
+    
+    // Owner: push in bursts of 8, pop one back after each burst
+    size_t pushed = 0;
+    while (pushed < items) {
+        for (int k = 0; k < 8 && pushed < items; ++k) {
+            q.push(make_task<Payload>(pushed++));
+        }
+        if (q.try_pop()) {
+            taken.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    while (taken.load(std::memory_order_relaxed) < items) {
+        if (q.try_pop()) {
+            taken.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    auto elapsed = Clock::now() - start;
+    
+    std::string pattern = "owner+" + std::to_string(thieves) + "T (" 
+        + std::to_string(stolen.load() * 100 / items) + "% stolen)";
+    return finish(Adapter::name, pattern, Payload, items * 2, elapsed, q.lock_stats());
+}
+
+template<size_t Payload>
+void run_payload(std::vector<QueueResult>& results, size_t ops, 
+                 const std::vector<std::pair<size_t, size_t>>& pc, 
+                 const std::vector<size_t>& thieves, bool instrument) {
+    for (auto [p, c] : pc) {
+        results.push_back(mpmc<TaskQueueAdapter, Payload>(ops, p, c, instrument));
+        results.push_back(mpmc<DequeAdapter, Payload>(ops, p, c, instrument));
+        results.push_back(mpmc<MutexDequeAdapter, Payload>(ops, p, c, instrument));
+    }
+    for (size_t t : thieves) {
+        results.push_back(owner_thieves<DequeAdapter, Payload>(ops, t, instrument));
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t ops = bench::arg_value(argc, argv, "ops", 200000);
+    size_t producers = bench::arg_value(argc, argv, "producers", 0);
+    size_t consumers = bench::arg_value(argc, argv, "consumers", 0);
+    size_t thieves = bench::arg_value(argc, argv, "thieves", 0);
+    size_t payload = bench::arg_value(argc, argv, "payload", 0);
+    bool instrument = bench::arg_value(argc, argv, "instrument", 0) != 0;
+    
+    std::vector<std::pair<size_t, size_t>> pc = {{1, 1}, {2, 2}, {4, 4}, {8, 1}, {1, 8}};
+    std::vector<size_t> thief_counts = {1, 2, 4, 8};
+    if (producers > 0 || consumers > 0) {
+        pc = {{std::max<size_t>(producers, 1), std::max<size_t>(consumers, 1)}};
+    }
+    if (thieves > 0) {
+        thief_counts = {thieves};
+    }
+    
+    std::cout << "=== cpp-threadpool Queue Microbenchmarks ===" << std::endl;
+    std::cout << "Items per run: " << ops << " (each pushed and popped once; ns/op counts both)" << std::endl;
+    
+    std::vector<QueueResult> results;
+    if (payload == 0 || payload == 8) run_payload<8>(results, ops, pc, thief_counts, instrument);
+    if (payload == 0 || payload == 64) run_payload<64>(results, ops, pc, thief_counts, instrument);
+    if (payload == 0 || payload == 256) run_payload<256>(results, ops, pc, thief_counts, instrument);
+    
+    std::cout << "\n" << std::left << std::setw(26) << "Queue"
+              << std::setw(28) << "Pattern"
+              << std::right << std::setw(9) << "Payload"
+              << std::setw(11) << "ns/op"
+              << std::setw(11) << "Mops/s";
+    if (instrument) {
+        std::cout << std::setw(12) << "Contended";
+    }
+    std::cout << std::endl << std::string(instrument ? 97 : 85, '-') << std::endl;
+    
+    for (const auto& r : results) {
+        std::cout << std::left << std::setw(26) << r.queue
+                  << std::setw(28) << r.pattern
+                  << std::right << std::setw(9) << r.payload
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(11) << r.ns_per_op
+                  << std::setw(11) << std::setprecision(2) << r.mops_per_sec;
+        if (instrument) {
+            std::cout << std::setw(11) << std::setprecision(1) << r.locks.contention_rate() * 100.0 << "%";
+        }
+        std::cout << std::endl;
+    }
+    
+    return 0;
+}
@@ -0,0 +1,222 @@
+/**
+ * @file benchmark_scaling.cpp
+ * @brief Thread-count scaling sweep with CPU topology reporting
+ * 
+ * Usage: benchmark_scaling [--total-ms N] [--csv path]
+ * 
+ * Sweeps 1, 2, 4, ... threads up to all logical CPUs, the physical core
+ * count, and 2x/4x oversubscription, for several task granularities. Each
+ * point runs the same total amount of compute; speedup is against a serial
+ * loop over identical work.
+ */
+
+#include "bench_common.hpp"
+
+#include <threadpool/threadpool.hpp>
+#include <cmath>
+#include <fstream>
+#include <set>
+#include <thread>
+
+#if defined(__APPLE__)
+#include <sys/sysctl.h>
+#endif
+
+using bench::Clock;
+
+/**
+ * @brief Detected CPU topology (zeros when unknown)
+ */
+struct Topology {
+    size_t sockets = 0;
+    size_t physical_cores = 0;
+    size_t logical_cpus = 0;
+    
+    size_t smt_ways() const {
+        return physical_cores > 0 ? logical_cpus / physical_cores : 1;
+    }
+};
+
+Topology detect_topology() {
+    Topology topo;
+    topo.logical_cpus = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    
+#if defined(__linux__)
+    std::set<int> packages;
+    std::set<std::pair<int, int>> cores;
+    size_t online = 0;
+    for (size_t cpu = 0; cpu < 4096; ++cpu) {
+        std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/";
+        std::ifstream pkg_file(base + "physical_package_id");
+        std::ifstream core_file(base + "core_id");
+        int pkg = 0, core = 0;
+        if (!(pkg_file >> pkg) || !(core_file >> core)) {
+            if (cpu > topo.logical_cpus * 2) {
+                break;
+            }
+            continue;
+        }
+        ++online;
+        packages.insert(pkg);
+        cores.insert({pkg, core});
+    }
+    if (online > 0) {
+        topo.sockets = packages.size();
+        topo.physical_cores = cores.size();
+    }
+#elif defined(__APPLE__)
+    int value = 0;
+    size_t size = sizeof(value);
+    if (sysctlbyname("hw.packages", &value, &size, nullptr, 0) == 0) {
+        topo.sockets = static_cast<size_t>(value);
+    }
+    size = sizeof(value);
+    if (sysctlbyname("hw.physicalcpu", &value, &size, nullptr, 0) == 0) {
+        topo.physical_cores = static_cast<size_t>(value);
+    }
+#endif
+    
+    if (topo.physical_cores == 0) {
+        topo.physical_cores = topo.logical_cpus;
+    }
+    if (topo.sockets == 0) {
+        topo.sockets = 1;
+    }
+    return topo;
+}
+
+/**
+ * @brief Compute kernel: a chain of sin() calls the compiler cannot drop
+ */
+double compute(size_t iterations, size_t seed) {
+    double result = 0.0;
+    for (size_t j = 0; j < iterations; ++j) {
+        result += std::sin(static_cast<double>(seed + j));
+    }
+    return result;
+}
+
+/**
+ * @brief Iterations of compute() per microsecond on this machine
+ */
+double calibrate() {
+    size_t iterations = 1 << 20;
+    auto start = Clock::now();
+    volatile double sink = compute(iterations, 1);
+    (void)sink;
+    double us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+    return static_cast<double>(iterations) / us;
+}
+
+/**
+ * @brief One (granularity, threads) measurement
+ */
+struct ScalingPoint {
+    double granularity_us;
+    size_t threads;
+    size_t tasks;
+    double time_ms;
+    double speedup;
+    double efficiency;
+    bool oversubscribed;
+};
+
+double run_pool(size_t threads, size_t tasks, size_t iterations) {
+    tp::ThreadPool pool(threads);
+    std::vector<std::future<double>> futures;
+    futures.reserve(tasks);
+    
+    auto start = Clock::now();
+    for (size_t i = 0; i < tasks; ++i) {
+        futures.push_back(pool.submit(compute, iterations, i));
+    }
+    double sum = 0.0;
+    for (auto& f : futures) {
+        sum += f.get();
+    }
+    volatile double sink = sum;
+    (void)sink;
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+double run_serial(size_t tasks, size_t iterations) {
+    auto start = Clock::now();
+    double sum = 0.0;
+    for (size_t i = 0; i < tasks; ++i) {
+        sum += compute(iterations, i);
+    }
+    volatile double sink = sum;
+    (void)sink;
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+std::vector<size_t> sweep_points(const Topology& topo) {
+    std::set<size_t> points;
+    for (size_t t : bench::thread_sweep(topo.logical_cpus)) {
+        points.insert(t);
+    }
+    points.insert(topo.physical_cores);
+    points.insert(topo.logical_cpus * 2);
+    points.insert(topo.logical_cpus * 4);
+    return {points.begin(), points.end()};
+}
+
+int main(int argc, char** argv) {
+    double total_ms = static_cast<double>(bench::arg_value(argc, argv, "total-ms", 500));
+    std::string csv_path = bench::arg_string(argc, argv, "csv", "");
+    
+    Topology topo = detect_topology();
+    std::cout << "=== cpp-threadpool Scaling Sweep ===" << std::endl;
+    std::cout << "Topology: " << topo.sockets << " socket(s), " << topo.physical_cores 
+              << " physical core(s), " << topo.logical_cpus << " logical CPU(s), SMT x" 
+              << topo.smt_ways() << std::endl;
+    
+    double iterations_per_us = calibrate();
+    auto threads = sweep_points(topo);
+    
+    std::vector<ScalingPoint> points;
+    for (double granularity_us : {1.0, 10.0, 100.0, 1000.0}) {
+        size_t iterations = std::max<size_t>(1, static_cast<size_t>(granularity_us * iterations_per_us));
+        size_t tasks = std::max<size_t>(1, static_cast<size_t>(total_ms * 1000.0 / granularity_us));
+        double serial_ms = run_serial(tasks, iterations);
+        
+        std::cout << "\n--- Granularity " << std::fixed << std::setprecision(0) << granularity_us 
+                  << " us, " << tasks << " tasks (serial " << std::setprecision(2) << serial_ms << " ms) ---" << std::endl;
+        std::cout << std::right << std::setw(8) << "Threads"
+                  << std::setw(14) << "Time (ms)"
+                  << std::setw(10) << "Speedup"
+                  << std::setw(12) << "Efficiency"
+                  << std::endl;
+        std::cout << std::string(44, '-') << std::endl;
+        
+        for (size_t t : threads) {
+            double ms = run_pool(t, tasks, iterations);
+            // Efficiency is relative to the CPUs actually available
+            size_t usable = std::min(t, topo.logical_cpus);
+            ScalingPoint p{granularity_us, t, tasks, ms, serial_ms / ms, 
+                           serial_ms / ms / static_cast<double>(usable), t > topo.logical_cpus};
+            points.push_back(p);
+            
+            std::cout << std::setw(8) << t
+                      << std::setw(14) << std::setprecision(2) << p.time_ms
+                      << std::setw(9) << p.speedup << "x"
+                      << std::setw(11) << std::setprecision(1) << p.efficiency * 100.0 << "%"
+                      << (p.oversubscribed ? "  (oversubscribed)" : "")
+                      << std::endl;
+        }
+    }
+    
+    if (!csv_path.empty()) {
+        std::ofstream csv(csv_path);
+        csv << "sockets,physical_cores,logical_cpus,granularity_us,threads,tasks,time_ms,speedup,efficiency,oversubscribed\n";
+        for (const auto& p : points) {
+            csv << topo.sockets << ',' << topo.physical_cores << ',' << topo.logical_cpus << ','
+                << p.granularity_us << ',' << p.threads << ',' << p.tasks << ','
+                << p.time_ms << ',' << p.speedup << ',' << p.efficiency << ','
+                << (p.oversubscribed ? 1 : 0) << '\n';
+        }
+        std::cout << "\nWrote " << points.size() << " rows to " << csv_path << std::endl;
+    }
+    
+    return 0;
+}
@@ -0,0 +1,316 @@
+/**
+ * @file benchmark_suite.cpp
+ * @brief Google Benchmark suite with thread/task-size/producer sweeps
+ * 
+ * Compare runs across versions and machines with JSON output:
+ *   benchmark_suite --benchmark_format=json --benchmark_out=run.json \
+ *                   --benchmark_repetitions=5
+ * 
+ * Arguments are reported as threads / work_ns / producers / n in each
+ * benchmark name.
+ */
+
+#include "bench_common.hpp"
+
+#include <threadpool/threadpool.hpp>
+#include <threadpool/concurrent_hash_map.hpp>
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+namespace {
+
+constexpr int64_t kBatch = 1000;
+
+/**
+ * @brief Thread counts 1, 2, 4, ... up to (and including) hardware concurrency
+ */
+std::vector<int64_t> thread_counts() {
+    int64_t hw = std::max<int64_t>(1, std::thread::hardware_concurrency());
+    std::vector<int64_t> counts;
+    for (int64_t t = 1; t < hw; t *= 2) {
+        counts.push_back(t);
+    }
+    counts.push_back(hw);
+    return counts;
+}
+
+const std::vector<int64_t> kWorkNs = {0, 1000, 10000};
+
+/**
+ * @brief Spin until a countdown of fire-and-forget tasks reaches zero
+ */
+void wait_countdown(const std::atomic<int64_t>& remaining) {
+    while (remaining.load(std::memory_order_acquire) > 0) {
+        std::this_thread::yield();
+    }
+}
+
+void set_items(benchmark::State& state, int64_t per_iteration) {
+    state.SetItemsProcessed(state.iterations() * per_iteration);
+}
+
+} // namespace
+
+/**
+ * @brief submit() + future.wait() for a batch of tasks
+ */
+static void BM_Submit(benchmark::State& state) {
+    tp::ThreadPool pool(static_cast<size_t>(state.range(0)));
+    auto work = std::chrono::nanoseconds(state.range(1));
+    std::vector<std::future<void>> futures;
+    futures.reserve(kBatch);
+    
+    for (auto _ : state) {
+        futures.clear();
+        for (int64_t i = 0; i < kBatch; ++i) {
+            futures.push_back(pool.submit([work] { bench::spin_for(work); }));
+        }
+        for (auto& f : futures) {
+            f.wait();
+        }
+    }
+    set_items(state, kBatch);
+}
+BENCHMARK(BM_Submit)
+    ->ArgNames({"threads", "work_ns"})
+    ->ArgsProduct({thread_counts(), kWorkNs})
+    ->UseRealTime();
+
+/**
+ * @brief Fire-and-forget submission (future discarded, completion via counter)
+ */
+static void BM_SubmitDetached(benchmark::State& state) {
+    tp::ThreadPool pool(static_cast<size_t>(state.range(0)));
+    auto work = std::chrono::nanoseconds(state.range(1));
+    std::atomic<int64_t> remaining{0};
+    
+    for (auto _ : state) {
+        remaining.store(kBatch, std::memory_order_relaxed);
+        for (int64_t i = 0; i < kBatch; ++i) {
+            pool.submit([work, &remaining] {
+                bench::spin_for(work);
+                remaining.fetch_sub(1, std::memory_order_release);
+            });
+        }
+        wait_countdown(remaining);
+    }
+    set_items(state, kBatch);
+}
+BENCHMARK(BM_SubmitDetached)
+    ->ArgNames({"threads", "work_ns"})
+    ->ArgsProduct({thread_counts(), kWorkNs})
+    ->UseRealTime();
+
+/**
+ * @brief submit_priority() across 10 priority levels
+ */
+static void BM_SubmitPriority(benchmark::State& state) {
+    tp::ThreadPool pool(static_cast<size_t>(state.range(0)));
+    auto work = std::chrono::nanoseconds(state.range(1));
+    std::vector<std::future<void>> futures;
+    futures.reserve(kBatch);
+    
+    for (auto _ : state) {
+        futures.clear();
+        for (int64_t i = 0; i < kBatch; ++i) {
+            futures.push_back(pool.submit_priority(static_cast<int>(i % 10), [work] { 
+                bench::spin_for(work); 
+            }));
+        }
+        for (auto& f : futures) {
+            f.wait();
+        }
+    }
+    set_items(state, kBatch);
+}
+BENCHMARK(BM_SubmitPriority)
+    ->ArgNames({"threads", "work_ns"})
+    ->ArgsProduct({thread_counts(), kWorkNs})
+    ->UseRealTime();
+
+/**
+ * @brief Batches submitted concurrently by several external producer threads
+ */
+static void BM_MultiProducerSubmit(benchmark::State& state) {
+    tp::ThreadPool pool(static_cast<size_t>(state.range(0)));
+    auto work = std::chrono::nanoseconds(state.range(1));
+    int64_t producers = state.range(2);
+    int64_t per_producer = kBatch / producers;
+    std::atomic<int64_t> remaining{0};
+    
+    for (auto _ : state) {
+        remaining.store(per_producer * producers, std::memory_order_relaxed);
+        std::vector<std::thread> threads;
+        threads.reserve(static_cast<size_t>(producers));
+        for (int64_t p = 0; p < producers; ++p) {
+            threads.emplace_back([&pool, &remaining, work, per_producer] {
+                for (int64_t i = 0; i < per_producer; ++i) {
+                    pool.submit([work, &remaining] {
+                        bench::spin_for(work);
+                        remaining.fetch_sub(1, std::memory_order_release);
+                    });
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        wait_countdown(remaining);
+    }
+    set_items(state, per_producer * producers);
+}
+BENCHMARK(BM_MultiProducerSubmit)
+    ->ArgNames({"threads", "work_ns", "producers"})
+    ->ArgsProduct({thread_counts(), {0, 1000}, {1, 2, 4, 8}})
+    ->UseRealTime();
+
+/**
+ * @brief parallel_for over n indices
+ */
+static void BM_ParallelFor(benchmark::State& state) {
+    tp::ThreadPool pool(static_cast<size_t>(state.range(0)));
+    auto work = std::chrono::nanoseconds(state.range(1));
+    size_t n = static_cast<size_t>(state.range(2));
+    
+    for (auto _ : state) {
+        tp::parallel_for(pool, 0, n, [work](size_t) { bench::spin_for(work); });
+    }
+    set_items(state, state.range(2));
+}
+BENCHMARK(BM_ParallelFor)
+    ->ArgNames({"threads", "work_ns", "n"})
+    ->ArgsProduct({thread_counts(), kWorkNs, {1000, 10000}})
+    ->UseRealTime();
+
+/**
+ * @brief Map-reduce: parallel_map followed by a sequential sum
+ */
+static void BM_ParallelMapReduce(benchmark::State& state) {
+    tp::ThreadPool pool(static_cast<size_t>(state.range(0)));
+    auto work = std::chrono::nanoseconds(state.range(1));
+    std::vector<int64_t> input(static_cast<size_t>(state.range(2)));
+    std::iota(input.begin(), input.end(), 0);
+    
+    for (auto _ : state) {
+        auto mapped = tp::parallel_map(pool, input, [work](int64_t x) {
+            bench::spin_for(work);
+            return x * x;
+        });
+        benchmark::DoNotOptimize(std::accumulate(mapped.begin(), mapped.end(), int64_t{0}));
+    }
+    set_items(state, state.range(2));
+}
+BENCHMARK(BM_ParallelMapReduce)
+    ->ArgNames({"threads", "work_ns", "n"})
+    ->ArgsProduct({thread_counts(), kWorkNs, {1000, 10000}})
+    ->UseRealTime();
+
+/**
+ * @brief Fork-join tree: every task spawns two children until the given depth
+ * 
+ * Children are spawned from worker threads; completion is tracked with a
+ * counter so no worker blocks on a future.
+ */
+static void BM_ForkJoinTree(benchmark::State& state) {
+    tp::ThreadPool pool(static_cast<size_t>(state.range(0)));
+    auto work = std::chrono::nanoseconds(state.range(1));
+    int depth = static_cast<int>(state.range(2));
+    int64_t nodes = (int64_t{1} << (depth + 1)) - 1;
+    std::atomic<int64_t> remaining{0};
+    
+    std::function<void(int)> node = [&](int level) {
+        bench::spin_for(work);
+        if (level > 0) {
+            pool.submit(node, level - 1);
+            pool.submit(node, level - 1);
+        }
+        remaining.fetch_sub(1, std::memory_order_release);
+    };
+    
+    for (auto _ : state) {
+        remaining.store(nodes, std::memory_order_relaxed);
+        pool.submit(node, depth);
+        wait_countdown(remaining);
+    }
+    set_items(state, nodes);
+}
+BENCHMARK(BM_ForkJoinTree)
+    ->ArgNames({"threads", "work_ns", "depth"})
+    ->ArgsProduct({thread_counts(), {0, 1000}, {10, 14}})
+    ->UseRealTime();
+
+/**
+ * @brief Parallel counting into one shared atomic vs a WorkerLocal per worker
+ */
+static void BM_ParallelCount(benchmark::State& state) {
+    tp::ThreadPool pool(static_cast<size_t>(state.range(0)));
+    bool worker_local = state.range(1) != 0;
+    constexpr size_t kChunks = 64;
+    constexpr size_t kPerChunk = 10000;
+    
+    for (auto _ : state) {
+        if (worker_local) {
+            tp::WorkerLocal<size_t> counts(pool);
+            tp::parallel_for(pool, 0, kChunks, [&counts](size_t) {
+                for (size_t i = 0; i < kPerChunk; ++i) {
+                    benchmark::DoNotOptimize(++counts.local());
+                }
+            });
+            benchmark::DoNotOptimize(counts.combine(std::plus<size_t>()));
+        } else {
+            std::atomic<size_t> count{0};
+            tp::parallel_for(pool, 0, kChunks, [&count](size_t) {
+                for (size_t i = 0; i < kPerChunk; ++i) {
+                    count.fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+            benchmark::DoNotOptimize(count.load());
+        }
+    }
+    set_items(state, static_cast<int64_t>(kChunks * kPerChunk));
+}
+BENCHMARK(BM_ParallelCount)
+    ->ArgNames({"threads", "worker_local"})
+    ->ArgsProduct({thread_counts(), {0, 1}})
+    ->UseRealTime();
+
+/**
+ * @brief Concurrent insert-if-absent: one mutex around a set vs the sharded set
+ */
+static void BM_VisitedInsert(benchmark::State& state) {
+    tp::ThreadPool pool(static_cast<size_t>(state.range(0)));
+    bool sharded = state.range(1) != 0;
+    constexpr size_t kChunks = 64;
+    constexpr size_t kPerChunk = 2000;
+    
+    for (auto _ : state) {
+        // Every key is offered twice, as a crawler re-discovers links
+        if (sharded) {
+            tp::ConcurrentHashSet<uint64_t> visited;
+            tp::parallel_for(pool, 0, kChunks, [&visited](size_t chunk) {
+                for (size_t i = 0; i < kPerChunk; ++i) {
+                    benchmark::DoNotOptimize(visited.insert((chunk / 2) * kPerChunk + i));
+                }
+            });
+        } else {
+            std::mutex mutex;
+            std::unordered_set<uint64_t> visited;
+            tp::parallel_for(pool, 0, kChunks, [&](size_t chunk) {
+                for (size_t i = 0; i < kPerChunk; ++i) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    benchmark::DoNotOptimize(visited.insert((chunk / 2) * kPerChunk + i).second);
+                }
+            });
+        }
+    }
+    set_items(state, static_cast<int64_t>(kChunks * kPerChunk));
+}
+BENCHMARK(BM_VisitedInsert)
+    ->ArgNames({"threads", "sharded"})
+    ->ArgsProduct({thread_counts(), {0, 1}})
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
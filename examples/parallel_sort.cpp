@@ -1,9 +1,10 @@
 /**
  * @file parallel_sort.cpp
- * @brief Parallel merge sort using cpp-threadpool
+ * @brief Parallel merge sort and radix sort using cpp-threadpool
  */
 
 #include <threadpool/threadpool.hpp>
+#include <threadpool/parallel_radix_sort.hpp>
 #include <iostream>
 #include <vector>
 #include <algorithm>
@@ -77,8 +78,9 @@ void parallel_merge_sort(tp::ThreadPool& pool, std::vector<T>& arr,
         parallel_merge_sort(pool, arr, mid + 1, right, threshold);
     });
     
-    future_left.wait();
-    future_right.wait();
+    // Run queued tasks while waiting so nested sorts cannot starve the pool
+    pool.wait_helping(future_left);
+    pool.wait_helping(future_right);
     
     merge(arr, left, mid, right);
 }
@@ -111,7 +113,7 @@ bool is_sorted(const std::vector<T>& vec) {
 }
 
 int main() {
-    std::cout << "=== Parallel Merge Sort Demo ===" << std::endl;
+    std::cout << "=== Parallel Sort Demo ===" << std::endl;
     std::cout << std::endl;
     
     const size_t SIZE = 1000000;
@@ -120,6 +122,7 @@ int main() {
     auto data_seq = generate_random_vector(SIZE);
     auto data_par = data_seq;  // Copy for parallel sort
     auto data_std = data_seq;  // Copy for std::sort
+    auto data_radix = data_seq;  // Copy for radix sort
     
     // Sequential merge sort
     std::cout << "\n1. Sequential merge sort..." << std::endl;
@@ -150,16 +153,30 @@ int main() {
     auto std_time = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
     std::cout << "   Time: " << std_time.count() << " ms" << std::endl;
     
+    // Parallel radix sort
+    std::cout << "\n4. Parallel radix sort..." << std::endl;
+    start = std::chrono::high_resolution_clock::now();
+    tp::parallel_radix_sort(pool, data_radix.begin(), data_radix.end());
+    end = std::chrono::high_resolution_clock::now();
+    auto radix_time = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    std::cout << "   Time: " << radix_time.count() << " ms" << std::endl;
+    std::cout << "   Sorted: " << (data_radix == data_std ? "Yes" : "No") << std::endl;
+    
     // Summary
     std::cout << "\n=== Summary ===" << std::endl;
     std::cout << "Sequential: " << seq_time.count() << " ms" << std::endl;
     std::cout << "Parallel:   " << par_time.count() << " ms" << std::endl;
     std::cout << "std::sort:  " << std_time.count() << " ms" << std::endl;
+    std::cout << "Radix:      " << radix_time.count() << " ms" << std::endl;
     
     if (seq_time.count() > 0) {
         double speedup = static_cast<double>(seq_time.count()) / par_time.count();
         std::cout << "\nParallel speedup: " << speedup << "x" << std::endl;
     }
+    if (radix_time.count() > 0) {
+        double speedup = static_cast<double>(par_time.count()) / radix_time.count();
+        std::cout << "Radix vs parallel merge: " << speedup << "x" << std::endl;
+    }
     
     return 0;
 }
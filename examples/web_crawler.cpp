@@ -3,16 +3,16 @@
  * @brief Simulated web crawler using cpp-threadpool
  * 
  * This example demonstrates:
- * - Producer-consumer pattern
- * - Dynamic task submission
+ * - Level-synchronous graph traversal (tp::parallel_bfs)
  * - Task with varying durations
+ * - Per-worker random generators (tp::this_worker::rng)
  */
 
 #include <threadpool/threadpool.hpp>
+#include <threadpool/parallel_bfs.hpp>
 #include <iostream>
 #include <vector>
 #include <string>
-#include <set>
 #include <mutex>
 #include <random>
 #include <chrono>
@@ -44,8 +44,7 @@ public:
     // Get random links from a "page"
     std::vector<std::string> get_links(const std::string& url) {
         std::vector<std::string> links;
-        std::random_device rd;
-        std::mt19937 gen(rd());
+        auto& gen = tp::this_worker::rng();
         std::uniform_int_distribution<> count_dist(0, 3);
         std::uniform_int_distribution<> url_dist(0, static_cast<int>(urls_.size() - 1));
         
@@ -69,57 +68,52 @@ public:
         , max_depth_(max_depth)
     {}
     
-    void start(const std::string& seed_url) {
+    // Crawl level by level; returns once every reachable page is done
+    void run(const std::string& seed_url) {
         std::cout << "Starting crawl from: " << seed_url << std::endl;
         std::cout << "Max depth: " << max_depth_ << std::endl;
         std::cout << std::endl;
         
-        crawl(seed_url, 0);
-    }
-    
-    void wait_complete() {
-        pool_.wait();
+        tp::BfsOptions options;
+        options.chunk_size = 1;   // Pages are slow; one task each
+        options.max_depth = static_cast<size_t>(max_depth_) + 1;
+        
+        stats_ = tp::parallel_bfs(pool_, std::vector<std::string>{seed_url},
+            [this](const std::string& url, size_t depth, auto& emit) {
+                crawl(url, depth, emit);
+            }, options);
     }
     
     void print_stats() {
-        std::lock_guard<std::mutex> lock(mutex_);
         std::cout << "\n=== Crawl Statistics ===" << std::endl;
-        std::cout << "URLs visited: " << visited_.size() << std::endl;
-        std::cout << "Total tasks submitted: " << tasks_submitted_ << std::endl;
+        std::cout << "URLs visited: " << stats_.visited << std::endl;
+        std::cout << "Links examined: " << stats_.edges << std::endl;
+        std::cout << "Pages per depth:";
+        for (size_t count : stats_.frontier_sizes) {
+            std::cout << " " << count;
+        }
+        std::cout << std::endl;
     }
     
 private:
-    void crawl(const std::string& url, int depth) {
-        // Check if already visited
+    template<typename Emit>
+    void crawl(const std::string& url, size_t depth, Emit& emit) {
+        // Simulate network delay
+        std::uniform_int_distribution<> delay_dist(10, 100);
+        std::this_thread::sleep_for(std::chrono::milliseconds(delay_dist(tp::this_worker::rng())));
+        
+        // Log progress
         {
-            std::lock_guard<std::mutex> lock(mutex_);
-            if (visited_.count(url) > 0 || depth > max_depth_) {
-                return;
-            }
-            visited_.insert(url);
-            ++tasks_submitted_;
+            std::lock_guard<std::mutex> lock(output_mutex_);
+            std::cout << "[Depth " << depth << "] Crawled: " << url << std::endl;
         }
         
-        // Submit crawl task
-        pool_.submit([this, url, depth] {
-            // Simulate network delay
-            std::random_device rd;
-            std::mt19937 gen(rd());
-            std::uniform_int_distribution<> delay_dist(10, 100);
-            std::this_thread::sleep_for(std::chrono::milliseconds(delay_dist(gen)));
-            
-            // Log progress
-            {
-                std::lock_guard<std::mutex> lock(mutex_);
-                std::cout << "[Depth " << depth << "] Crawled: " << url << std::endl;
+        // Links below the last level are not followed
+        if (depth < static_cast<size_t>(max_depth_)) {
+            for (const auto& link : db_.get_links(url)) {
+                emit(link);
             }
-            
-            // Get links and crawl them
-            auto links = db_.get_links(url);
-            for (const auto& link : links) {
-                crawl(link, depth + 1);
-            }
-        });
+        }
     }
     
 private:
@@ -127,9 +121,8 @@ private:
     URLDatabase db_;
     int max_depth_;
     
-    std::mutex mutex_;
-    std::set<std::string> visited_;
-    int tasks_submitted_ = 0;
+    std::mutex output_mutex_;
+    tp::BfsStats stats_;
 };
 
 int main() {
@@ -146,8 +139,7 @@ int main() {
     
     auto start = std::chrono::high_resolution_clock::now();
     
-    crawler.start("https://example.com");
-    crawler.wait_complete();
+    crawler.run("https://example.com");
     
     auto end = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
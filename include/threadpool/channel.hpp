@@ -0,0 +1,494 @@
+#pragma once
+
+/**
+ * @file channel.hpp
+ * @brief Multi-producer multi-consumer channel whose waits never block a worker
+ * 
+ * Values live in a fixed ring of cells with per-cell sequence numbers
+ * (Vyukov's bounded MPMC queue): while the channel is neither empty nor full,
+ * send and receive are one CAS each and take no lock. Only a receive on an
+ * empty channel, a send on a full one, or an unbounded channel's overflow
+ * goes through the mutex, where the request is parked as a waiter and
+ * completed by whichever side makes progress possible.
+ * 
+ * A parked request is a future or a callback, not a blocked thread. Callback
+ * forms are submitted to the pool when they complete, so a pipeline stage
+ * written as "receive, then handle in a continuation" occupies no worker
+ * while it waits. C++17 has no coroutines, so this continuation style (or
+ * pool.wait_helping() on the future) stands in for co_await.
+ */
+
+#include "threadpool.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace tp {
+
+/**
+ * @brief Bounded or unbounded MPMC channel integrated with a ThreadPool
+ * 
+ * Values from one producer are received in the order they were sent. After
+ * close(), sends fail and receives drain what is buffered, then yield
+ * std::nullopt. Destroying a channel with parked requests breaks their
+ * futures and drops their callbacks.
+ * 
+ * @code
+ * tp::Channel<Item> items(pool, 64);
+ * items.async_send(item);                        // future<bool>
+ * items.async_receive([](std::optional<Item> item) {
+ *     if (item) process(*item);                  // runs as a pool task
+ * });
+ * @endcode
+ */
+template<typename T>
+class Channel {
+public:
+    static constexpr size_t unbounded = 0;
+    
+    // Ring size of an unbounded channel; values beyond it overflow to a list
+    static constexpr size_t unbounded_ring_capacity = 1024;
+    
+    /**
+     * @param capacity Maximum buffered values, or Channel::unbounded
+     */
+    explicit Channel(ThreadPool& pool, size_t capacity = unbounded)
+        : pool_(pool)
+        , bounded_(capacity != unbounded)
+        , ring_capacity_(bounded_ ? capacity : unbounded_ring_capacity)
+        , cells_(std::make_unique<Cell[]>(ring_capacity_))
+    {
+        for (size_t i = 0; i < ring_capacity_; ++i) {
+            cells_[i].sequence.store(2 * i, std::memory_order_relaxed);
+        }
+    }
+    
+    Channel(const Channel&) = delete;
+    Channel& operator=(const Channel&) = delete;
+    
+    /**
+     * @brief Send without waiting
+     * @return false if the channel is full (bounded) or closed; value is
+     *         left untouched in that case
+     */
+    bool try_send(const T& value) {
+        return send_now(value);
+    }
+    
+    bool try_send(T&& value) {
+        return send_now(std::move(value));
+    }
+    
+    /**
+     * @brief Receive without waiting
+     * @return std::nullopt if nothing is buffered
+     */
+    std::optional<T> try_receive() {
+        std::optional<T> value = ring_pop();
+        if (!value && overflow_size_.load(std::memory_order_acquire) > 0) {
+            Handoffs handoffs;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                value = pop_locked();
+                settle_locked(handoffs);
+            }
+            handoffs.run();
+            return value;
+        }
+        if (value) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (senders_waiting_.load(std::memory_order_relaxed) > 0) {
+                settle();
+            }
+        }
+        return value;
+    }
+    
+    /**
+     * @brief Send, parking the value if the channel is full
+     * @return Future that becomes true once the value is buffered or handed
+     *         to a receiver, false if the channel is closed first
+     */
+    std::future<bool> async_send(T value) {
+        auto promise = std::make_shared<std::promise<bool>>();
+        auto result = promise->get_future();
+        send_with(std::move(value), [promise](bool sent) { promise->set_value(sent); });
+        return result;
+    }
+    
+    /**
+     * @brief Send, then submit callback(sent) to the pool once it completes
+     * @return Future of the callback's result
+     */
+    template<typename F>
+    auto async_send(T value, F&& callback)
+        -> std::future<std::invoke_result_t<F, bool>>
+    {
+        auto task = std::make_shared<std::packaged_task<std::invoke_result_t<F, bool>(bool)>>(
+            std::forward<F>(callback));
+        auto result = task->get_future();
+        send_with(std::move(value), [pool = &pool_, task](bool sent) {
+            schedule(*pool, [task, sent] { (*task)(sent); });
+        });
+        return result;
+    }
+    
+    /**
+     * @brief Receive, parking the request if the channel is empty
+     * @return Future of the next value, or std::nullopt once closed and drained
+     */
+    std::future<std::optional<T>> async_receive() {
+        auto promise = std::make_shared<std::promise<std::optional<T>>>();
+        auto result = promise->get_future();
+        receive_with([promise](std::optional<T> value) {
+            promise->set_value(std::move(value));
+        });
+        return result;
+    }
+    
+    /**
+     * @brief Receive, then submit callback(value) to the pool
+     * 
+     * The callback sees std::nullopt once the channel is closed and drained.
+     * @return Future of the callback's result
+     */
+    template<typename F>
+    auto async_receive(F&& callback)
+        -> std::future<std::invoke_result_t<F, std::optional<T>>>
+    {
+        using ReturnType = std::invoke_result_t<F, std::optional<T>>;
+        auto task = std::make_shared<std::packaged_task<ReturnType(std::optional<T>)>>(
+            std::forward<F>(callback));
+        auto result = task->get_future();
+        receive_with([pool = &pool_, task](std::optional<T> value) {
+            auto shared = std::make_shared<std::optional<T>>(std::move(value));
+            schedule(*pool, [task, shared] { (*task)(std::move(*shared)); });
+        });
+        return result;
+    }
+    
+    /**
+     * @brief Refuse further sends and complete every parked request
+     * 
+     * Parked sends complete with false; parked receives get what is still
+     * buffered, then std::nullopt.
+     */
+    void close() {
+        Handoffs handoffs;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_.store(true, std::memory_order_seq_cst);
+            settle_locked(handoffs);
+        }
+        handoffs.run();
+    }
+    
+    bool is_closed() const noexcept {
+        return closed_.load(std::memory_order_acquire);
+    }
+    
+    bool is_bounded() const noexcept {
+        return bounded_;
+    }
+    
+    /**
+     * @brief Maximum buffered values (0 for an unbounded channel)
+     */
+    size_t capacity() const noexcept {
+        return bounded_ ? ring_capacity_ : unbounded;
+    }
+    
+    /**
+     * @brief Buffered values; approximate while other threads are active
+     */
+    size_t size() const noexcept {
+        uint64_t tail = tail_.load(std::memory_order_acquire);
+        uint64_t head = head_.load(std::memory_order_acquire);
+        size_t in_ring = tail > head ? static_cast<size_t>(tail - head) : 0;
+        return in_ring + overflow_size_.load(std::memory_order_acquire);
+    }
+    
+    /**
+     * @brief Receives parked on an empty channel
+     */
+    size_t waiting_receivers() const noexcept {
+        return receivers_waiting_.load(std::memory_order_acquire);
+    }
+    
+    /**
+     * @brief Sends parked on a full channel
+     */
+    size_t waiting_senders() const noexcept {
+        return senders_waiting_.load(std::memory_order_acquire);
+    }
+
+private:
+    using Receiver = std::function<void(std::optional<T>)>;
+    using SendDone = std::function<void(bool)>;
+    
+    // The cell for position pos is free when sequence == 2 * pos and holds
+    // that position's value at 2 * pos + 1. Doubling keeps the two states
+    // distinct even when the ring has a single cell.
+    struct Cell {
+        std::atomic<uint64_t> sequence{0};
+        std::optional<T> value;
+    };
+    
+    struct ParkedSend {
+        T value;
+        SendDone done;
+    };
+    
+    /**
+     * @brief Completions collected under the lock and run after releasing it
+     */
+    struct Handoffs {
+        std::vector<std::pair<Receiver, std::optional<T>>> received;
+        std::vector<std::pair<SendDone, bool>> sent;
+        
+        void run() {
+            for (auto& [receiver, value] : received) {
+                receiver(std::move(value));
+            }
+            for (auto& [done, ok] : sent) {
+                done(ok);
+            }
+        }
+    };
+    
+    /**
+     * @brief Submit a continuation; on a stopped pool run it on this thread
+     */
+    template<typename Job>
+    static void schedule(ThreadPool& pool, const Job& job) {
+        try {
+            pool.submit(job);
+        } catch (const std::runtime_error&) {
+            job();
+        }
+    }
+    
+    template<typename U>
+    bool ring_push(U&& value) {
+        uint64_t pos = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos % ring_capacity_];
+            uint64_t seq = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<int64_t>(seq - 2 * pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value.emplace(std::forward<U>(value));
+                    cell.sequence.store(2 * pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // Full: the cell still holds a value from the previous lap
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+    
+    std::optional<T> ring_pop() {
+        uint64_t pos = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos % ring_capacity_];
+            uint64_t seq = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<int64_t>(seq - (2 * pos + 1));
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    std::optional<T> value(std::move(*cell.value));
+                    cell.value.reset();
+                    cell.sequence.store(2 * (pos + ring_capacity_), std::memory_order_release);
+                    return value;
+                }
+            } else if (diff < 0) {
+                return std::nullopt;  // Empty, or the next value is still being written
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+    
+    template<typename U>
+    bool send_now(U&& value) {
+        // Announce the send before checking closed_; close() checks in the
+        // opposite order, so it either makes us fail here or sees us in
+        // flight and keeps parked receivers waiting for our value
+        sends_in_flight_.fetch_add(1, std::memory_order_seq_cst);
+        if (closed_.load(std::memory_order_seq_cst)) {
+            finish_send();
+            return false;
+        }
+        // Once values overflow or sends are parked, later sends must queue
+        // behind them or one producer's values could be reordered
+        bool pushed = overflow_size_.load(std::memory_order_acquire) == 0 &&
+                      senders_waiting_.load(std::memory_order_acquire) == 0 &&
+                      ring_push(std::forward<U>(value));
+        finish_send();
+        if (pushed) {
+            // Pairs with the fence in receive_with(): either the parked
+            // receiver sees this value or we see the receiver
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (receivers_waiting_.load(std::memory_order_relaxed) > 0) {
+                settle();
+            }
+            return true;
+        }
+        if (bounded_) {
+            return false;
+        }
+        
+        Handoffs handoffs;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (closed_.load(std::memory_order_relaxed)) {
+                return false;
+            }
+            if (!overflow_.empty() || !ring_push(std::forward<U>(value))) {
+                overflow_.push_back(std::forward<U>(value));
+                overflow_size_.store(overflow_.size(), std::memory_order_release);
+            }
+            settle_locked(handoffs);
+        }
+        handoffs.run();
+        return true;
+    }
+    
+    /**
+     * @brief Leave the lock-free send path; the last one out after close()
+     *        completes the receivers close() left parked
+     */
+    void finish_send() {
+        if (sends_in_flight_.fetch_sub(1, std::memory_order_seq_cst) == 1 &&
+            closed_.load(std::memory_order_seq_cst)) {
+            settle();
+        }
+    }
+    
+    void send_with(T value, SendDone done) {
+        if (send_now(std::move(value))) {
+            done(true);
+            return;
+        }
+        // send_now() leaves the value alone when it fails
+        Handoffs handoffs;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            senders_.push_back(ParkedSend{std::move(value), std::move(done)});
+            senders_waiting_.store(senders_.size(), std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            settle_locked(handoffs);
+        }
+        handoffs.run();
+    }
+    
+    void receive_with(Receiver receiver) {
+        if (auto value = try_receive()) {
+            receiver(std::move(value));
+            return;
+        }
+        Handoffs handoffs;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            receivers_.push_back(std::move(receiver));
+            receivers_waiting_.store(receivers_.size(), std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            settle_locked(handoffs);
+        }
+        handoffs.run();
+    }
+    
+    void settle() {
+        Handoffs handoffs;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            settle_locked(handoffs);
+        }
+        handoffs.run();
+    }
+    
+    std::optional<T> pop_locked() {
+        std::optional<T> value = ring_pop();
+        if (!value && !overflow_.empty()) {
+            value.emplace(std::move(overflow_.front()));
+            overflow_.pop_front();
+            overflow_size_.store(overflow_.size(), std::memory_order_release);
+        }
+        return value;
+    }
+    
+    /**
+     * @brief Match parked sends with free space and parked receives with values
+     */
+    void settle_locked(Handoffs& handoffs) {
+        bool progress = true;
+        while (progress) {
+            progress = false;
+            while (!senders_.empty() && !closed_.load(std::memory_order_relaxed) &&
+                   ring_push(std::move(senders_.front().value))) {
+                handoffs.sent.emplace_back(std::move(senders_.front().done), true);
+                senders_.pop_front();
+                progress = true;
+            }
+            while (!receivers_.empty()) {
+                std::optional<T> value = pop_locked();
+                if (!value) {
+                    break;
+                }
+                handoffs.received.emplace_back(std::move(receivers_.front()), std::move(value));
+                receivers_.pop_front();
+                progress = true;
+            }
+        }
+        
+        if (closed_.load(std::memory_order_relaxed)) {
+            for (auto& parked : senders_) {
+                handoffs.sent.emplace_back(std::move(parked.done), false);
+            }
+            senders_.clear();
+            // Receivers are only left over once the buffer is drained. A send
+            // that passed its closed_ check may still be about to push, and
+            // finish_send() settles again once the last one is done.
+            if (sends_in_flight_.load(std::memory_order_seq_cst) == 0) {
+                for (auto& receiver : receivers_) {
+                    handoffs.received.emplace_back(std::move(receiver), std::nullopt);
+                }
+                receivers_.clear();
+            }
+        }
+        
+        senders_waiting_.store(senders_.size(), std::memory_order_relaxed);
+        receivers_waiting_.store(receivers_.size(), std::memory_order_relaxed);
+    }
+    
+    ThreadPool& pool_;
+    const bool bounded_;
+    const size_t ring_capacity_;
+    std::unique_ptr<Cell[]> cells_;
+    
+    alignas(detail::cache_line_size) std::atomic<uint64_t> head_{0};
+    alignas(detail::cache_line_size) std::atomic<uint64_t> tail_{0};
+    alignas(detail::cache_line_size) std::atomic<size_t> receivers_waiting_{0};
+    std::atomic<size_t> senders_waiting_{0};
+    std::atomic<size_t> overflow_size_{0};
+    std::atomic<bool> closed_{false};
+    std::atomic<size_t> sends_in_flight_{0};
+    
+    std::mutex mutex_;
+    std::deque<Receiver> receivers_;
+    std::deque<ParkedSend> senders_;
+    std::deque<T> overflow_;
+};
+
+} // namespace tp
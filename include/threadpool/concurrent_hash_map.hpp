@@ -0,0 +1,304 @@
+#pragma once
+
+/**
+ * @file concurrent_hash_map.hpp
+ * @brief Sharded concurrent hash set and map
+ * 
+ * Keys are spread over a power-of-two number of shards, each an unordered
+ * container behind its own mutex on its own cache line. Operations on
+ * different shards never contend; the hash is computed before any lock is
+ * taken. Iteration locks one shard at a time and is not a snapshot.
+ */
+
+#include "threadpool.hpp"
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace tp {
+
+namespace detail {
+
+/**
+ * @brief Default shard count: next power of two >= 4x hardware threads, at least 16
+ */
+inline size_t default_shard_count() noexcept {
+    size_t target = std::max<size_t>(std::thread::hardware_concurrency() * 4, 16);
+    size_t count = 1;
+    while (count < target) {
+        count <<= 1;
+    }
+    return count;
+}
+
+/**
+ * @brief Fixed array of padded, individually locked containers
+ */
+template<typename Container, typename Hash>
+class ShardedTable {
+public:
+    struct alignas(cache_line_size) Shard {
+        mutable std::mutex mutex;
+        Container items;
+    };
+    
+    ShardedTable(size_t shard_count, const Hash& hash)
+        : hash_(hash)
+    {
+        size_t count = 1;
+        while (count < std::max<size_t>(shard_count, 1)) {
+            count <<= 1;
+        }
+        shard_count_ = count;
+        shift_ = 64;
+        while (count > 1) {
+            count >>= 1;
+            --shift_;
+        }
+        shards_ = std::make_unique<Shard[]>(shard_count_);
+    }
+    
+    template<typename Key>
+    Shard& shard_for(const Key& key) const noexcept {
+        // Fibonacci hashing so weak hashes (identity for integers) still spread
+        uint64_t h = static_cast<uint64_t>(hash_(key)) * 0x9e3779b97f4a7c15ULL;
+        size_t index = shift_ >= 64 ? 0 : static_cast<size_t>(h >> shift_);
+        return shards_[index];
+    }
+    
+    size_t shard_count() const noexcept {
+        return shard_count_;
+    }
+    
+    Shard& shard(size_t index) const noexcept {
+        return shards_[index];
+    }
+    
+    size_t size() const {
+        size_t total = 0;
+        for (size_t i = 0; i < shard_count_; ++i) {
+            std::lock_guard<std::mutex> lock(shards_[i].mutex);
+            total += shards_[i].items.size();
+        }
+        return total;
+    }
+    
+    void clear() {
+        for (size_t i = 0; i < shard_count_; ++i) {
+            std::lock_guard<std::mutex> lock(shards_[i].mutex);
+            shards_[i].items.clear();
+        }
+    }
+    
+    void reserve(size_t expected) {
+        size_t per_shard = expected / shard_count_ + 1;
+        for (size_t i = 0; i < shard_count_; ++i) {
+            std::lock_guard<std::mutex> lock(shards_[i].mutex);
+            shards_[i].items.reserve(per_shard);
+        }
+    }
+
+private:
+    Hash hash_;
+    size_t shard_count_ = 1;
+    unsigned shift_ = 64;
+    std::unique_ptr<Shard[]> shards_;
+};
+
+} // namespace detail
+
+/**
+ * @brief Thread-safe hash set with striped locking
+ * 
+ * @code
+ * tp::ConcurrentHashSet<std::string> visited;
+ * if (visited.insert(url)) {
+ *     // first thread to see url
+ * }
+ * @endcode
+ */
+template<typename Key, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class ConcurrentHashSet {
+public:
+    explicit ConcurrentHashSet(size_t shard_count = detail::default_shard_count(),
+                               const Hash& hash = Hash())
+        : table_(shard_count, hash)
+    {}
+    
+    ConcurrentHashSet(const ConcurrentHashSet&) = delete;
+    ConcurrentHashSet& operator=(const ConcurrentHashSet&) = delete;
+    
+    /**
+     * @brief Insert if absent
+     * @return true if the key was inserted by this call
+     */
+    bool insert(const Key& key) {
+        auto& shard = table_.shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return shard.items.insert(key).second;
+    }
+    
+    bool insert(Key&& key) {
+        auto& shard = table_.shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return shard.items.insert(std::move(key)).second;
+    }
+    
+    bool contains(const Key& key) const {
+        auto& shard = table_.shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return shard.items.count(key) > 0;
+    }
+    
+    /**
+     * @return true if the key was present
+     */
+    bool erase(const Key& key) {
+        auto& shard = table_.shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return shard.items.erase(key) > 0;
+    }
+    
+    /**
+     * @brief Call func(key) for every element, one shard lock at a time
+     */
+    template<typename Func>
+    void for_each(Func&& func) const {
+        for (size_t i = 0; i < table_.shard_count(); ++i) {
+            auto& shard = table_.shard(i);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            for (const auto& key : shard.items) {
+                func(key);
+            }
+        }
+    }
+    
+    size_t size() const { return table_.size(); }
+    bool empty() const { return size() == 0; }
+    void clear() { table_.clear(); }
+    void reserve(size_t expected) { table_.reserve(expected); }
+    size_t shard_count() const noexcept { return table_.shard_count(); }
+
+private:
+    detail::ShardedTable<std::unordered_set<Key, Hash, KeyEqual>, Hash> table_;
+};
+
+/**
+ * @brief Thread-safe hash map with striped locking
+ * 
+ * Values are returned by copy; use update()/upsert() to modify a value in
+ * place under its shard lock.
+ */
+template<typename Key, typename T, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class ConcurrentHashMap {
+public:
+    explicit ConcurrentHashMap(size_t shard_count = detail::default_shard_count(),
+                               const Hash& hash = Hash())
+        : table_(shard_count, hash)
+    {}
+    
+    ConcurrentHashMap(const ConcurrentHashMap&) = delete;
+    ConcurrentHashMap& operator=(const ConcurrentHashMap&) = delete;
+    
+    /**
+     * @brief Insert if absent
+     * @return true if the key was inserted by this call
+     */
+    bool insert(const Key& key, T value) {
+        auto& shard = table_.shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return shard.items.try_emplace(key, std::move(value)).second;
+    }
+    
+    /**
+     * @return true if the key was newly inserted, false if it was overwritten
+     */
+    bool insert_or_assign(const Key& key, T value) {
+        auto& shard = table_.shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return shard.items.insert_or_assign(key, std::move(value)).second;
+    }
+    
+    std::optional<T> find(const Key& key) const {
+        auto& shard = table_.shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.items.find(key);
+        if (it == shard.items.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+    
+    bool contains(const Key& key) const {
+        auto& shard = table_.shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return shard.items.count(key) > 0;
+    }
+    
+    /**
+     * @brief Apply func(value) if the key is present
+     * @return true if the key was present
+     */
+    template<typename Func>
+    bool update(const Key& key, Func&& func) {
+        auto& shard = table_.shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.items.find(key);
+        if (it == shard.items.end()) {
+            return false;
+        }
+        func(it->second);
+        return true;
+    }
+    
+    /**
+     * @brief Apply func(value), value-initialising the entry first if absent
+     * @return true if the entry was created by this call
+     */
+    template<typename Func>
+    bool upsert(const Key& key, Func&& func) {
+        auto& shard = table_.shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto [it, inserted] = shard.items.try_emplace(key);
+        func(it->second);
+        return inserted;
+    }
+    
+    /**
+     * @return true if the key was present
+     */
+    bool erase(const Key& key) {
+        auto& shard = table_.shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return shard.items.erase(key) > 0;
+    }
+    
+    /**
+     * @brief Call func(key, value) for every entry, one shard lock at a time
+     */
+    template<typename Func>
+    void for_each(Func&& func) const {
+        for (size_t i = 0; i < table_.shard_count(); ++i) {
+            auto& shard = table_.shard(i);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            for (const auto& [key, value] : shard.items) {
+                func(key, value);
+            }
+        }
+    }
+    
+    size_t size() const { return table_.size(); }
+    bool empty() const { return size() == 0; }
+    void clear() { table_.clear(); }
+    void reserve(size_t expected) { table_.reserve(expected); }
+    size_t shard_count() const noexcept { return table_.shard_count(); }
+
+private:
+    detail::ShardedTable<std::unordered_map<Key, T, Hash, KeyEqual>, Hash> table_;
+};
+
+} // namespace tp
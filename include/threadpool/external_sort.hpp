@@ -0,0 +1,632 @@
+#pragma once
+
+/**
+ * @file external_sort.hpp
+ * @brief Parallel external merge sort for files of fixed-size binary records
+ * 
+ * Three phases, all bounded by the memory budget:
+ * 1. Run generation: slices of the input are read, sorted on the pool and
+ *    spilled to temporary run files. Two runs are in flight at a time, so
+ *    one is read while the other is sorted and written.
+ * 2. Intermediate merges: while there are more runs than one merge can
+ *    buffer, groups of runs are merged into longer runs, groups in parallel.
+ * 3. Final merge: keys sampled during run generation split the output into
+ *    one key range per worker; each range is merged from every run straight
+ *    into its slice of the output file.
+ * 
+ * Every merge reads each run through two blocks, prefetching the next block
+ * on the pool while the current one is consumed, and writes the same way.
+ * Waits use wait_helping(), so the sort may itself run inside a task.
+ */
+
+#include "threadpool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <iomanip>
+#include <memory>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace tp {
+
+/**
+ * @brief Tuning knobs for external_sort
+ */
+struct ExternalSortOptions {
+    // Upper bound on record buffers held at once, across all tasks
+    size_t memory_budget = size_t{256} << 20;
+    
+    // Where run files are spilled; empty means the system temp directory
+    std::filesystem::path temp_directory;
+    
+    // Smallest I/O block; merges with more runs than this allows for are
+    // split into extra passes
+    size_t min_block_bytes = 64 * 1024;
+};
+
+/**
+ * @brief What an external_sort call did
+ */
+struct ExternalSortStats {
+    uint64_t records = 0;
+    size_t runs = 0;            // Sorted runs spilled by run generation
+    size_t merge_passes = 0;    // Including the final merge
+    size_t partitions = 0;      // Key ranges merged in parallel by the final pass
+    std::chrono::nanoseconds elapsed{0};
+};
+
+namespace detail {
+
+inline std::runtime_error external_sort_error(const std::string& what,
+                                              const std::filesystem::path& path) {
+    return std::runtime_error("external_sort: " + what + " '" + path.string() + "'");
+}
+
+template<typename T>
+void read_records(std::istream& in, const std::filesystem::path& path,
+                  uint64_t index, T* dst, size_t count) {
+    in.seekg(static_cast<std::streamoff>(index * sizeof(T)));
+    in.read(reinterpret_cast<char*>(dst), static_cast<std::streamsize>(count * sizeof(T)));
+    if (!in || static_cast<size_t>(in.gcount()) != count * sizeof(T)) {
+        throw external_sort_error("short read from", path);
+    }
+}
+
+template<typename T>
+void write_records(std::ostream& out, const std::filesystem::path& path,
+                   uint64_t index, const T* src, size_t count) {
+    out.seekp(static_cast<std::streamoff>(index * sizeof(T)));
+    out.write(reinterpret_cast<const char*>(src), static_cast<std::streamsize>(count * sizeof(T)));
+    if (!out) {
+        throw external_sort_error("write failed on", path);
+    }
+}
+
+struct SortRun {
+    std::filesystem::path path;
+    uint64_t records = 0;
+};
+
+/**
+ * @brief Removes the spill directory however the sort exits
+ */
+struct SpillDirectory {
+    explicit SpillDirectory(const std::filesystem::path& parent) {
+        const auto base = parent.empty() ? std::filesystem::temp_directory_path() : parent;
+        std::filesystem::create_directories(base);
+        
+        // Not this_worker::rng(): under PoolConfig::rng_seed that stream repeats
+        // across processes. create_directory() returning false means the name
+        // is taken (possibly by a concurrent sort), so pick another.
+        static std::atomic<uint64_t> sequence{0};
+        std::random_device entropy;
+        for (int attempt = 0; attempt < 64; ++attempt) {
+            uint64_t salt = (static_cast<uint64_t>(entropy()) << 32) ^ entropy() ^
+                static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()) ^
+                (sequence.fetch_add(1, std::memory_order_relaxed) * 0x9e3779b97f4a7c15ULL);
+            std::ostringstream name;
+            name << "tp-external-sort-" << std::hex << salt;
+            if (std::filesystem::create_directory(base / name.str())) {
+                path = base / name.str();
+                return;
+            }
+        }
+        throw external_sort_error("cannot create a spill directory in", base);
+    }
+    
+    ~SpillDirectory() {
+        std::error_code ec;
+        std::filesystem::remove_all(path, ec);
+    }
+    
+    SpillDirectory(const SpillDirectory&) = delete;
+    SpillDirectory& operator=(const SpillDirectory&) = delete;
+    
+    std::filesystem::path path;
+};
+
+/**
+ * @brief Sort data[0, n) on the pool, using scratch[0, n) as merge space
+ * @return Whichever of data or scratch holds the sorted records
+ */
+template<typename T, typename Compare>
+T* sort_buffer(ThreadPool& pool, T* data, T* scratch, size_t n, Compare& comp) {
+    const size_t pieces = std::clamp<size_t>(n / 4096, 1, std::max<size_t>(pool.size(), 1) * 2);
+    auto bound = [&](size_t i) { return n * std::min(i, pieces) / pieces; };
+    
+    auto sort_piece = [&](size_t i) {
+        std::sort(data + bound(i), data + bound(i + 1), comp);
+    };
+    run_chunks(pool, pieces, sort_piece);
+    
+    T* src = data;
+    T* dst = scratch;
+    for (size_t width = 1; width < pieces; width *= 2) {
+        auto merge_pair = [&](size_t g) {
+            size_t lo = bound(2 * g * width);
+            size_t mid = bound((2 * g + 1) * width);
+            size_t hi = bound((2 * g + 2) * width);
+            std::merge(src + lo, src + mid, src + mid, src + hi, dst + lo, comp);
+        };
+        run_chunks(pool, (pieces + 2 * width - 1) / (2 * width), merge_pair);
+        std::swap(src, dst);
+    }
+    return src;
+}
+
+/**
+ * @brief Sequential reader over records [begin, end) of a run, one block ahead
+ */
+template<typename T>
+class RunReader {
+public:
+    RunReader(ThreadPool& pool, const SortRun& run, uint64_t begin, uint64_t end, size_t block)
+        : pool_(pool)
+        , path_(run.path)
+        , in_(run.path, std::ios::binary)
+        , current_(block)
+        , next_(block)
+        , next_index_(begin)
+        , end_(end)
+    {
+        if (!in_) {
+            throw external_sort_error("cannot open", path_);
+        }
+        prefetch();
+        refill();
+    }
+    
+    ~RunReader() {
+        if (pending_.valid()) {
+            pool_.wait_helping(pending_);
+        }
+    }
+    
+    RunReader(const RunReader&) = delete;
+    RunReader& operator=(const RunReader&) = delete;
+    
+    bool empty() const noexcept {
+        return pos_ == size_;
+    }
+    
+    const T& front() const noexcept {
+        return current_[pos_];
+    }
+    
+    void pop() {
+        if (++pos_ == size_) {
+            refill();
+        }
+    }
+
+private:
+    void prefetch() {
+        next_size_ = static_cast<size_t>(std::min<uint64_t>(next_.size(), end_ - next_index_));
+        if (next_size_ == 0) {
+            return;
+        }
+        pending_ = pool_.submit([this, index = next_index_, count = next_size_] {
+            read_records(in_, path_, index, next_.data(), count);
+        });
+        next_index_ += next_size_;
+    }
+    
+    void refill() {
+        pos_ = 0;
+        size_ = 0;
+        if (!pending_.valid()) {
+            return;
+        }
+        pool_.wait_helping(pending_);
+        pending_.get();
+        std::swap(current_, next_);
+        size_ = next_size_;
+        prefetch();
+    }
+    
+    ThreadPool& pool_;
+    std::filesystem::path path_;
+    std::ifstream in_;
+    std::vector<T> current_;
+    std::vector<T> next_;
+    size_t pos_ = 0;
+    size_t size_ = 0;
+    size_t next_size_ = 0;
+    uint64_t next_index_;
+    const uint64_t end_;
+    std::future<void> pending_;
+};
+
+/**
+ * @brief Sequential writer from a record index on, one block written behind
+ */
+template<typename T>
+class RunWriter {
+public:
+    RunWriter(ThreadPool& pool, const std::filesystem::path& path, uint64_t index,
+              size_t block, bool create)
+        : pool_(pool)
+        , path_(path)
+        , out_(path, create ? std::ios::binary | std::ios::out | std::ios::trunc
+                            : std::ios::binary | std::ios::in | std::ios::out)
+        , index_(index)
+        , block_(block)
+    {
+        if (!out_) {
+            throw external_sort_error("cannot open", path_);
+        }
+        current_.reserve(block_);
+        spare_.reserve(block_);
+    }
+    
+    ~RunWriter() {
+        if (pending_.valid()) {
+            pool_.wait_helping(pending_);
+        }
+    }
+    
+    RunWriter(const RunWriter&) = delete;
+    RunWriter& operator=(const RunWriter&) = delete;
+    
+    void push(const T& record) {
+        current_.push_back(record);
+        if (current_.size() == block_) {
+            flush();
+        }
+    }
+    
+    /**
+     * @brief Write what is buffered and wait for all writes to land
+     */
+    void finish() {
+        flush();
+        wait();
+        out_.close();
+        if (!out_) {
+            throw external_sort_error("write failed on", path_);
+        }
+    }
+
+private:
+    void wait() {
+        if (pending_.valid()) {
+            pool_.wait_helping(pending_);
+            pending_.get();
+        }
+    }
+    
+    void flush() {
+        if (current_.empty()) {
+            return;
+        }
+        wait();
+        std::swap(current_, spare_);
+        current_.clear();
+        pending_ = pool_.submit([this, index = index_] {
+            write_records(out_, path_, index, spare_.data(), spare_.size());
+        });
+        index_ += spare_.size();
+    }
+    
+    ThreadPool& pool_;
+    std::filesystem::path path_;
+    std::fstream out_;
+    uint64_t index_;
+    const size_t block_;
+    std::vector<T> current_;
+    std::vector<T> spare_;
+    std::future<void> pending_;
+};
+
+/**
+ * @brief k-way merge of ranges[i] of runs[i] into output from record out_index on
+ */
+template<typename T, typename Compare>
+void merge_runs(ThreadPool& pool, const std::vector<SortRun>& runs,
+                const std::vector<std::pair<uint64_t, uint64_t>>& ranges,
+                const std::filesystem::path& output, uint64_t out_index, bool create,
+                size_t block, Compare& comp) {
+    std::vector<std::unique_ptr<RunReader<T>>> readers;
+    readers.reserve(runs.size());
+    for (size_t i = 0; i < runs.size(); ++i) {
+        readers.push_back(std::make_unique<RunReader<T>>(
+            pool, runs[i], ranges[i].first, ranges[i].second, block));
+    }
+    RunWriter<T> writer(pool, output, out_index, block, create);
+    
+    // Min-heap of reader indices; ties go to the earlier run
+    auto later = [&](size_t a, size_t b) {
+        if (comp(readers[b]->front(), readers[a]->front())) {
+            return true;
+        }
+        if (comp(readers[a]->front(), readers[b]->front())) {
+            return false;
+        }
+        return a > b;
+    };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(later)> heap(later);
+    for (size_t i = 0; i < readers.size(); ++i) {
+        if (!readers[i]->empty()) {
+            heap.push(i);
+        }
+    }
+    
+    while (!heap.empty()) {
+        size_t i = heap.top();
+        heap.pop();
+        writer.push(readers[i]->front());
+        readers[i]->pop();
+        if (!readers[i]->empty()) {
+            heap.push(i);
+        }
+    }
+    writer.finish();
+}
+
+/**
+ * @brief First record index in [0, run.records) not less than key
+ */
+template<typename T, typename Compare>
+uint64_t run_lower_bound(const SortRun& run, const T& key, Compare& comp) {
+    std::ifstream in(run.path, std::ios::binary);
+    if (!in) {
+        throw external_sort_error("cannot open", run.path);
+    }
+    uint64_t lo = 0;
+    uint64_t hi = run.records;
+    T probe;
+    while (lo < hi) {
+        uint64_t mid = lo + (hi - lo) / 2;
+        read_records(in, run.path, mid, &probe, 1);
+        if (comp(probe, key)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+} // namespace detail
+
+/**
+ * @brief Sort a file of fixed-size binary records into output_path
+ * 
+ * The input is read as an array of T (its size must be a multiple of
+ * sizeof(T)) and written in ascending comp order; equal records may be
+ * reordered. comp is called concurrently. Throws std::runtime_error on I/O
+ * failure; spilled runs are removed either way.
+ * 
+ * @code
+ * auto stats = tp::external_sort<Record>(pool, "in.bin", "out.bin", 1ull << 30,
+ *     [](const Record& a, const Record& b) { return a.key < b.key; });
+ * @endcode
+ */
+template<typename T, typename Compare = std::less<T>>
+ExternalSortStats external_sort(ThreadPool& pool,
+                                const std::filesystem::path& input_path,
+                                const std::filesystem::path& output_path,
+                                const ExternalSortOptions& options,
+                                Compare comp = Compare()) {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "external_sort: records are read and written as raw bytes");
+    
+    auto start = std::chrono::steady_clock::now();
+    ExternalSortStats stats;
+    
+    std::error_code ec;
+    const uint64_t bytes = std::filesystem::file_size(input_path, ec);
+    if (ec) {
+        throw detail::external_sort_error("cannot stat", input_path);
+    }
+    if (bytes % sizeof(T) != 0) {
+        throw detail::external_sort_error("size is not a multiple of the record size in", input_path);
+    }
+    const uint64_t total = bytes / sizeof(T);
+    stats.records = total;
+    
+    // Everything below runs at most this many merges or sorts at once: each
+    // worker plus a helping caller
+    const size_t concurrency = pool.size() + 1;
+    const size_t budget = std::max(options.memory_budget, sizeof(T) * 64 * concurrency);
+    const size_t min_block = std::max<size_t>(options.min_block_bytes / sizeof(T), 1);
+    
+    // Largest fan-in at which every concurrent merge gets two min-size blocks
+    // per run plus two for output
+    const size_t blocks = budget / (sizeof(T) * concurrency * min_block);
+    const size_t fan_in = std::max<size_t>(blocks / 2, 3) - 1;
+    auto block_for = [&](size_t merges, size_t runs) {
+        return std::max<size_t>(budget / (sizeof(T) * merges * (2 * runs + 2)), 1);
+    };
+    
+    detail::SpillDirectory spill(options.temp_directory);
+    
+    // Phase 1: two runs in flight, each holding its records and merge space
+    const uint64_t run_records = std::max<uint64_t>(budget / (4 * sizeof(T)), 1);
+    std::vector<detail::SortRun> runs(static_cast<size_t>((total + run_records - 1) / run_records));
+    const size_t partitions = static_cast<size_t>(
+        std::clamp<uint64_t>(total / (4 * min_block), 1, std::max<size_t>(pool.size(), 1)));
+    std::vector<std::vector<T>> samples(runs.size());
+    
+    auto generate_run = [&](size_t r) {
+        const uint64_t first = r * run_records;
+        const size_t count = static_cast<size_t>(std::min(run_records, total - first));
+        std::vector<T> data(count);
+        std::vector<T> scratch(count);
+        
+        std::ifstream in(input_path, std::ios::binary);
+        if (!in) {
+            throw detail::external_sort_error("cannot open", input_path);
+        }
+        detail::read_records(in, input_path, first, data.data(), count);
+        const T* sorted = detail::sort_buffer(pool, data.data(), scratch.data(), count, comp);
+        
+        std::ostringstream name;
+        name << "run-" << std::setw(6) << std::setfill('0') << r << ".bin";
+        runs[r].path = spill.path / name.str();
+        runs[r].records = count;
+        std::ofstream out(runs[r].path, std::ios::binary | std::ios::trunc);
+        detail::write_records(out, runs[r].path, 0, sorted, count);
+        
+        // Evenly spaced keys from every run approximate the key distribution
+        const size_t wanted = partitions * 8;
+        const size_t stride = std::max<size_t>(count / wanted, 1);
+        for (size_t i = stride / 2; i < count; i += stride) {
+            samples[r].push_back(sorted[i]);
+        }
+    };
+    
+    std::deque<std::future<void>> in_flight;
+    auto drain = [&](size_t keep) {
+        while (in_flight.size() > keep) {
+            pool.wait_helping(in_flight.front());
+            auto done = std::move(in_flight.front());
+            in_flight.pop_front();
+            done.get();
+        }
+    };
+    try {
+        for (size_t r = 0; r < runs.size(); ++r) {
+            drain(1);
+            in_flight.push_back(pool.submit([&generate_run, r] { generate_run(r); }));
+        }
+        drain(0);
+    } catch (...) {
+        // Let in-flight runs finish before unwinding the state they reference
+        for (auto& f : in_flight) {
+            pool.wait_helping(f);
+        }
+        throw;
+    }
+    stats.runs = runs.size();
+    
+    // Phase 2: merge groups of fan_in runs until one merge can take them all
+    while (runs.size() > fan_in) {
+        const size_t groups = (runs.size() + fan_in - 1) / fan_in;
+        const size_t merges = std::min(groups, concurrency);
+        std::vector<detail::SortRun> merged(groups);
+        std::atomic<size_t> next_group{0};
+        
+        // One task per concurrent merge pulling groups, so helping waits
+        // cannot start more merges than the budget was divided between
+        auto merge_groups = [&](size_t) {
+            for (size_t g = next_group++; g < groups; g = next_group++) {
+                size_t lo = g * fan_in;
+                size_t hi = std::min(runs.size(), lo + fan_in);
+                std::vector<detail::SortRun> group(runs.begin() + lo, runs.begin() + hi);
+                std::vector<std::pair<uint64_t, uint64_t>> ranges;
+                for (const auto& run : group) {
+                    ranges.emplace_back(0, run.records);
+                    merged[g].records += run.records;
+                }
+                std::ostringstream name;
+                name << "pass-" << stats.merge_passes << "-" << std::setw(6)
+                     << std::setfill('0') << g << ".bin";
+                merged[g].path = spill.path / name.str();
+                detail::merge_runs<T>(pool, group, ranges, merged[g].path, 0, true,
+                                      block_for(merges, group.size()), comp);
+                for (const auto& run : group) {
+                    std::error_code ignored;
+                    std::filesystem::remove(run.path, ignored);
+                }
+            }
+        };
+        detail::run_chunks(pool, merges, merge_groups);
+        runs = std::move(merged);
+        ++stats.merge_passes;
+    }
+    
+    // Phase 3: split the key space at sampled keys and merge each range
+    // into its own slice of the output
+    {
+        std::ofstream create(output_path, std::ios::binary | std::ios::trunc);
+        if (!create) {
+            throw detail::external_sort_error("cannot create", output_path);
+        }
+    }
+    std::filesystem::resize_file(output_path, total * sizeof(T), ec);
+    if (ec) {
+        throw detail::external_sort_error("cannot create", output_path);
+    }
+    if (runs.empty()) {
+        stats.elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start);
+        return stats;
+    }
+    
+    std::vector<T> all_samples;
+    for (auto& s : samples) {
+        all_samples.insert(all_samples.end(), s.begin(), s.end());
+    }
+    std::sort(all_samples.begin(), all_samples.end(), comp);
+    std::vector<T> splitters;
+    for (size_t p = 1; p < partitions && !all_samples.empty(); ++p) {
+        splitters.push_back(all_samples[all_samples.size() * p / partitions]);
+    }
+    const size_t ranges_count = splitters.size() + 1;
+    
+    // bounds[r][p]: first record of run r in key range p
+    std::vector<std::vector<uint64_t>> bounds(runs.size());
+    auto find_bounds = [&](size_t r) {
+        bounds[r].push_back(0);
+        for (const auto& key : splitters) {
+            bounds[r].push_back(detail::run_lower_bound(runs[r], key, comp));
+        }
+        bounds[r].push_back(runs[r].records);
+    };
+    detail::run_chunks(pool, runs.size(), find_bounds);
+    
+    std::vector<uint64_t> out_begin(ranges_count, 0);
+    for (size_t p = 1; p < ranges_count; ++p) {
+        out_begin[p] = out_begin[p - 1];
+        for (size_t r = 0; r < runs.size(); ++r) {
+            out_begin[p] += bounds[r][p] - bounds[r][p - 1];
+        }
+    }
+    
+    const size_t block = block_for(ranges_count, runs.size());
+    auto merge_range = [&](size_t p) {
+        std::vector<std::pair<uint64_t, uint64_t>> ranges;
+        for (size_t r = 0; r < runs.size(); ++r) {
+            ranges.emplace_back(bounds[r][p], bounds[r][p + 1]);
+        }
+        detail::merge_runs<T>(pool, runs, ranges, output_path, out_begin[p], false, block, comp);
+    };
+    detail::run_chunks(pool, ranges_count, merge_range);
+    
+    ++stats.merge_passes;
+    stats.partitions = ranges_count;
+    stats.elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start);
+    return stats;
+}
+
+/**
+ * @brief external_sort with default options and the given memory budget
+ */
+template<typename T, typename Compare = std::less<T>>
+ExternalSortStats external_sort(ThreadPool& pool,
+                                const std::filesystem::path& input_path,
+                                const std::filesystem::path& output_path,
+                                size_t memory_budget,
+                                Compare comp = Compare()) {
+    ExternalSortOptions options;
+    options.memory_budget = memory_budget;
+    return external_sort<T>(pool, input_path, output_path, options, comp);
+}
+
+} // namespace tp
@@ -0,0 +1,351 @@
+#pragma once
+
+/**
+ * @file parallel_bfs.hpp
+ * @brief Level-synchronous parallel breadth-first search
+ * 
+ * Each level's frontier is split into chunks, one pool task per chunk.
+ * Tasks discover neighbours into private buffers that are concatenated into
+ * the next frontier, so the only shared write is the visited check. The
+ * caller waits with wait_helping(), so a BFS may itself run inside a task.
+ * 
+ * Two entry points:
+ * - parallel_bfs(pool, roots, expand): any hashable node type, neighbours
+ *   produced by a callback, deduplicated through a ConcurrentHashSet.
+ * - parallel_bfs(pool, graph, root): integer vertices in a CsrGraph, with
+ *   a per-vertex depth array and optional direction-optimising switch.
+ */
+
+#include "threadpool.hpp"
+#include "concurrent_hash_map.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+namespace tp {
+
+/**
+ * @brief Tuning knobs for parallel_bfs
+ */
+struct BfsOptions {
+    // Frontier nodes (or vertices, for bottom-up levels) per task
+    size_t chunk_size = 256;
+    
+    // Nodes at this depth are visited but not expanded
+    size_t max_depth = static_cast<size_t>(-1);
+    
+    // CsrGraph only: switch to bottom-up when the frontier is large
+    bool direction_optimizing = true;
+    
+    // Top-down -> bottom-up when frontier edges > unexplored edges / alpha;
+    // bottom-up -> top-down when frontier vertices < vertices / beta
+    double alpha = 14.0;
+    double beta = 24.0;
+};
+
+/**
+ * @brief What a traversal did
+ */
+struct BfsStats {
+    size_t levels = 0;                  // Levels expanded
+    size_t visited = 0;                 // Distinct nodes reached, roots included
+    size_t edges = 0;                   // Neighbours examined
+    size_t bottom_up_levels = 0;        // CsrGraph only
+    std::vector<size_t> frontier_sizes; // Frontier size of each expanded level
+    std::chrono::nanoseconds elapsed{0};
+};
+
+/**
+ * @brief Compressed sparse row adjacency of a graph with vertices 0..n-1
+ * 
+ * Direction-optimising BFS scans a vertex's own list to find parents, so
+ * the graph must be symmetric (undirected) when that option is enabled.
+ */
+struct CsrGraph {
+    std::vector<uint64_t> offsets;  // Size vertices() + 1
+    std::vector<uint32_t> targets;
+    
+    size_t vertices() const noexcept {
+        return offsets.empty() ? 0 : offsets.size() - 1;
+    }
+    
+    size_t edges() const noexcept {
+        return targets.size();
+    }
+    
+    size_t degree(uint32_t v) const noexcept {
+        return static_cast<size_t>(offsets[v + 1] - offsets[v]);
+    }
+};
+
+/**
+ * @brief Per-vertex BFS depth (-1 = unreachable) and traversal stats
+ */
+struct BfsResult {
+    std::vector<int32_t> depth;
+    BfsStats stats;
+};
+
+/**
+ * @brief Handed to the expand callback; call it once per neighbour
+ */
+template<typename Node, typename Hash = std::hash<Node>, typename KeyEqual = std::equal_to<Node>>
+class BfsEmitter {
+public:
+    BfsEmitter(ConcurrentHashSet<Node, Hash, KeyEqual>& visited, std::vector<Node>& next)
+        : visited_(visited)
+        , next_(next)
+    {}
+    
+    void operator()(const Node& node) {
+        ++edges_;
+        if (visited_.insert(node)) {
+            next_.push_back(node);
+        }
+    }
+    
+    size_t edges() const noexcept {
+        return edges_;
+    }
+
+private:
+    ConcurrentHashSet<Node, Hash, KeyEqual>& visited_;
+    std::vector<Node>& next_;
+    size_t edges_ = 0;
+};
+
+/**
+ * @brief Breadth-first search over an implicit graph
+ * @param roots Depth-0 nodes (duplicates are ignored)
+ * @param expand Called as expand(node, depth, emit) for every node shallower than
+ *        options.max_depth; calls emit(neighbour) for each neighbour
+ * 
+ * Nodes are expanded at most once. Within a level, expand runs concurrently
+ * on different nodes; levels are separated by a barrier.
+ * 
+ * @code
+ * auto stats = tp::parallel_bfs(pool, std::vector<std::string>{seed},
+ *     [&](const std::string& url, size_t depth, auto& emit) {
+ *         for (auto& link : fetch_links(url)) emit(link);
+ *     });
+ * @endcode
+ */
+template<typename Node, typename Expand, typename Hash = std::hash<Node>, typename KeyEqual = std::equal_to<Node>>
+BfsStats parallel_bfs(ThreadPool& pool, const std::vector<Node>& roots, Expand&& expand,
+                      const BfsOptions& options = BfsOptions()) {
+    auto start = std::chrono::steady_clock::now();
+    BfsStats stats;
+    ConcurrentHashSet<Node, Hash, KeyEqual> visited;
+    
+    std::vector<Node> frontier;
+    for (const auto& root : roots) {
+        if (visited.insert(root)) {
+            frontier.push_back(root);
+        }
+    }
+    stats.visited = frontier.size();
+    
+    size_t chunk_size = std::max<size_t>(options.chunk_size, 1);
+    for (size_t depth = 0; !frontier.empty() && depth < options.max_depth; ++depth) {
+        size_t chunks = (frontier.size() + chunk_size - 1) / chunk_size;
+        std::vector<std::vector<Node>> next(chunks);
+        std::vector<size_t> edges(chunks);
+        
+        auto body = [&](size_t c) {
+            BfsEmitter<Node, Hash, KeyEqual> emit(visited, next[c]);
+            size_t end = std::min(frontier.size(), (c + 1) * chunk_size);
+            for (size_t i = c * chunk_size; i < end; ++i) {
+                expand(frontier[i], depth, emit);
+            }
+            edges[c] = emit.edges();
+        };
+        detail::run_chunks(pool, chunks, body);
+        
+        stats.frontier_sizes.push_back(frontier.size());
+        ++stats.levels;
+        
+        size_t next_size = 0;
+        for (size_t c = 0; c < chunks; ++c) {
+            next_size += next[c].size();
+            stats.edges += edges[c];
+        }
+        std::vector<Node> merged;
+        merged.reserve(next_size);
+        for (auto& part : next) {
+            std::move(part.begin(), part.end(), std::back_inserter(merged));
+        }
+        frontier = std::move(merged);
+        stats.visited += next_size;
+    }
+    
+    stats.elapsed = std::chrono::steady_clock::now() - start;
+    return stats;
+}
+
+/**
+ * @brief Breadth-first search from one vertex of a CSR graph
+ * 
+ * Top-down levels claim vertices with a compare-and-swap on their depth.
+ * With options.direction_optimizing, large frontiers switch to bottom-up
+ * levels where every unvisited vertex scans its neighbours for a parent in
+ * a frontier bitmap, which touches far fewer edges on low-diameter graphs.
+ */
+inline BfsResult parallel_bfs(ThreadPool& pool, const CsrGraph& graph, uint32_t root,
+                              const BfsOptions& options = BfsOptions()) {
+    auto start = std::chrono::steady_clock::now();
+    const size_t n = graph.vertices();
+    BfsResult result;
+    if (root >= n) {
+        result.depth.assign(n, -1);
+        return result;
+    }
+    
+    auto depth = std::make_unique<std::atomic<int32_t>[]>(n);
+    for (size_t v = 0; v < n; ++v) {
+        depth[v].store(-1, std::memory_order_relaxed);
+    }
+    depth[root].store(0, std::memory_order_relaxed);
+    
+    BfsStats& stats = result.stats;
+    stats.visited = 1;
+    
+    const size_t chunk_size = std::max<size_t>(options.chunk_size, 1);
+    const size_t words = (n + 63) / 64;
+    
+    std::vector<uint32_t> frontier{root};
+    std::vector<uint64_t> frontier_bits;    // Used while bottom_up
+    size_t frontier_count = 1;
+    size_t frontier_edges = graph.degree(root);
+    size_t unexplored_edges = graph.edges() - frontier_edges;
+    bool bottom_up = false;
+    
+    for (int32_t level = 0; frontier_count > 0 && static_cast<size_t>(level) < options.max_depth; ++level) {
+        // Pick this level's direction
+        if (options.direction_optimizing) {
+            if (!bottom_up && static_cast<double>(frontier_edges) > static_cast<double>(unexplored_edges) / options.alpha) {
+                bottom_up = true;
+                frontier_bits.assign(words, 0);
+                for (uint32_t v : frontier) {
+                    frontier_bits[v / 64] |= uint64_t{1} << (v % 64);
+                }
+            } else if (bottom_up && static_cast<double>(frontier_count) < static_cast<double>(n) / options.beta) {
+                bottom_up = false;
+                frontier.clear();
+                for (size_t w = 0; w < words; ++w) {
+                    for (uint64_t bits = frontier_bits[w]; bits != 0; bits &= bits - 1) {
+                        int bit = 0;
+                        while (((bits >> bit) & 1) == 0) {
+                            ++bit;
+                        }
+                        frontier.push_back(static_cast<uint32_t>(w * 64 + static_cast<size_t>(bit)));
+                    }
+                }
+            }
+        }
+        
+        stats.frontier_sizes.push_back(frontier_count);
+        ++stats.levels;
+        
+        struct ChunkResult {
+            std::vector<uint32_t> next;
+            size_t count = 0;
+            size_t degree = 0;
+            size_t edges = 0;
+        };
+        
+        if (!bottom_up) {
+            size_t chunks = (frontier.size() + chunk_size - 1) / chunk_size;
+            std::vector<ChunkResult> parts(chunks);
+            auto body = [&](size_t c) {
+                ChunkResult& part = parts[c];
+                size_t end = std::min(frontier.size(), (c + 1) * chunk_size);
+                for (size_t i = c * chunk_size; i < end; ++i) {
+                    uint32_t v = frontier[i];
+                    for (uint64_t e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e) {
+                        uint32_t u = graph.targets[e];
+                        ++part.edges;
+                        int32_t expected = -1;
+                        if (depth[u].load(std::memory_order_relaxed) == -1 &&
+                            depth[u].compare_exchange_strong(expected, level + 1, std::memory_order_relaxed)) {
+                            part.next.push_back(u);
+                            part.degree += graph.degree(u);
+                        }
+                    }
+                }
+                part.count = part.next.size();
+            };
+            detail::run_chunks(pool, chunks, body);
+            
+            std::vector<uint32_t> next;
+            frontier_edges = 0;
+            for (auto& part : parts) {
+                next.insert(next.end(), part.next.begin(), part.next.end());
+                frontier_edges += part.degree;
+                stats.edges += part.edges;
+            }
+            frontier = std::move(next);
+            frontier_count = frontier.size();
+        } else {
+            // Chunks cover whole bitmap words so each task owns its words;
+            // chunk_size vertices, rounded up to a word
+            size_t words_per_chunk = std::max<size_t>((chunk_size + 63) / 64, 1);
+            size_t chunks = (words + words_per_chunk - 1) / words_per_chunk;
+            std::vector<uint64_t> next_bits(words, 0);
+            std::vector<ChunkResult> parts(chunks);
+            auto body = [&](size_t c) {
+                ChunkResult& part = parts[c];
+                size_t w_end = std::min(words, (c + 1) * words_per_chunk);
+                for (size_t w = c * words_per_chunk; w < w_end; ++w) {
+                    uint64_t found = 0;
+                    size_t v_end = std::min(n, (w + 1) * 64);
+                    for (size_t v = w * 64; v < v_end; ++v) {
+                        if (depth[v].load(std::memory_order_relaxed) != -1) {
+                            continue;
+                        }
+                        for (uint64_t e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e) {
+                            uint32_t u = graph.targets[e];
+                            ++part.edges;
+                            if ((frontier_bits[u / 64] >> (u % 64)) & 1) {
+                                depth[v].store(level + 1, std::memory_order_relaxed);
+                                found |= uint64_t{1} << (v % 64);
+                                ++part.count;
+                                part.degree += graph.degree(static_cast<uint32_t>(v));
+                                break;
+                            }
+                        }
+                    }
+                    next_bits[w] = found;
+                }
+            };
+            detail::run_chunks(pool, chunks, body);
+            
+            frontier_count = 0;
+            frontier_edges = 0;
+            for (const auto& part : parts) {
+                frontier_count += part.count;
+                frontier_edges += part.degree;
+                stats.edges += part.edges;
+            }
+            frontier_bits = std::move(next_bits);
+            ++stats.bottom_up_levels;
+        }
+        
+        stats.visited += frontier_count;
+        unexplored_edges -= std::min(unexplored_edges, frontier_edges);
+    }
+    
+    result.depth.resize(n);
+    for (size_t v = 0; v < n; ++v) {
+        result.depth[v] = depth[v].load(std::memory_order_relaxed);
+    }
+    stats.elapsed = std::chrono::steady_clock::now() - start;
+    return result;
+}
+
+} // namespace tp
@@ -0,0 +1,264 @@
+#pragma once
+
+/**
+ * @file parallel_radix_sort.hpp
+ * @brief Parallel LSD radix sort on integer keys
+ * 
+ * The range is split into contiguous chunks, one pool task per chunk, and
+ * sorted one 8-bit digit at a time:
+ * 1. each chunk counts its digits into a private histogram;
+ * 2. the histograms are prefix-summed into a write offset per (chunk, digit);
+ * 3. each chunk scatters its elements to those offsets, staging them in
+ *    cache-line sized write-combining buffers so stores go out a line at a
+ *    time instead of to 256 scattered destinations.
+ * 
+ * Digits that are equal across the whole input (e.g. the high bytes of small
+ * keys) are detected up front and skipped. The sort is stable. The caller
+ * waits with wait_helping(), so a sort may itself run inside a task.
+ */
+
+#include "threadpool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace tp {
+
+/**
+ * @brief Tuning knobs for parallel_radix_sort
+ */
+struct RadixSortOptions {
+    // Elements per task; the chunk count is also capped at 4x the pool size
+    size_t chunk_size = 64 * 1024;
+    
+    // Inputs smaller than this are sorted with std::stable_sort on the caller
+    size_t sequential_threshold = 4096;
+};
+
+namespace detail {
+
+constexpr size_t radix_bits = 8;
+constexpr size_t radix_buckets = size_t{1} << radix_bits;
+
+/**
+ * @brief Map an integral key to an unsigned value with the same ordering
+ */
+template<typename Key>
+constexpr std::make_unsigned_t<Key> radix_bits_of(Key key) noexcept {
+    using Bits = std::make_unsigned_t<Key>;
+    if constexpr (std::is_signed_v<Key>) {
+        // Flipping the sign bit orders negatives before positives
+        return static_cast<Bits>(key) ^ (Bits{1} << (std::numeric_limits<Bits>::digits - 1));
+    } else {
+        return key;
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief Stable parallel radix sort of [first, last) by key_fn(element)
+ * 
+ * key_fn must return an integral type (signed keys sort numerically) and is
+ * called concurrently, several times per element. Elements must be default
+ * constructible and move assignable; one scratch copy of the range is
+ * allocated.
+ * 
+ * @code
+ * tp::parallel_radix_sort(pool, records.begin(), records.end(),
+ *                         [](const Record& r) { return r.id; });
+ * @endcode
+ */
+template<typename RandomIt, typename KeyFn,
+         typename = std::enable_if_t<std::is_invocable_v<
+             KeyFn&, const typename std::iterator_traits<RandomIt>::value_type&>>>
+void parallel_radix_sort(ThreadPool& pool, RandomIt first, RandomIt last, KeyFn key_fn,
+                         const RadixSortOptions& options = {})
+{
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    using Key = std::decay_t<std::invoke_result_t<KeyFn&, const T&>>;
+    static_assert(std::is_integral_v<Key> && !std::is_same_v<Key, bool>,
+                  "parallel_radix_sort: key_fn must return an integral type");
+    using Bits = std::make_unsigned_t<Key>;
+    using Histogram = std::array<size_t, detail::radix_buckets>;
+    
+    constexpr size_t passes = sizeof(Bits) * 8 / detail::radix_bits;
+    constexpr size_t mask = detail::radix_buckets - 1;
+    
+    const size_t n = static_cast<size_t>(std::distance(first, last));
+    if (n < 2) {
+        return;
+    }
+    
+    auto digit = [&key_fn](const T& value, size_t pass) {
+        return static_cast<size_t>(
+            (detail::radix_bits_of<Key>(key_fn(value)) >> (pass * detail::radix_bits)) & mask);
+    };
+    
+    if (n < std::max<size_t>(options.sequential_threshold, 2)) {
+        std::stable_sort(first, last, [&key_fn](const T& a, const T& b) {
+            return detail::radix_bits_of<Key>(key_fn(a)) < detail::radix_bits_of<Key>(key_fn(b));
+        });
+        return;
+    }
+    
+    const size_t chunk_size = std::max<size_t>(options.chunk_size, 1);
+    const size_t max_chunks = std::max<size_t>(pool.size(), 1) * 4;
+    const size_t chunks = std::clamp<size_t>((n + chunk_size - 1) / chunk_size, 1, max_chunks);
+    const size_t per_chunk = (n + chunks - 1) / chunks;
+    auto chunk_begin = [&](size_t c) { return std::min(n, c * per_chunk); };
+    auto chunk_end = [&](size_t c) { return std::min(n, (c + 1) * per_chunk); };
+    
+    // Histograms for every digit in one read, to find the passes worth doing.
+    // They also serve as the first pass's per-chunk counts.
+    std::vector<std::array<Histogram, passes>> counts(chunks);
+    {
+        auto body = [&](size_t c) {
+            auto& local = counts[c];
+            for (auto& h : local) {
+                h.fill(0);
+            }
+            for (size_t i = chunk_begin(c), end = chunk_end(c); i < end; ++i) {
+                Bits bits = detail::radix_bits_of<Key>(key_fn(first[i]));
+                for (size_t p = 0; p < passes; ++p) {
+                    ++local[p][(bits >> (p * detail::radix_bits)) & mask];
+                }
+            }
+        };
+        detail::run_chunks(pool, chunks, body);
+    }
+    
+    std::vector<size_t> active;
+    for (size_t p = 0; p < passes; ++p) {
+        Histogram total{};
+        for (size_t c = 0; c < chunks; ++c) {
+            for (size_t b = 0; b < detail::radix_buckets; ++b) {
+                total[b] += counts[c][p][b];
+            }
+        }
+        if (std::find(total.begin(), total.end(), n) == total.end()) {
+            active.push_back(p);
+        }
+    }
+    if (active.empty()) {
+        return;
+    }
+    
+    std::vector<T> buffer(n);
+    std::vector<Histogram> histograms(chunks);
+    std::vector<Histogram> offsets(chunks);
+    
+    // Trivially copyable elements small enough for several per cache line go
+    // through write-combining buffers; anything else is moved directly.
+    constexpr bool combine = std::is_trivially_copyable_v<T> &&
+                             sizeof(T) <= detail::cache_line_size / 4;
+    constexpr size_t line = combine ? detail::cache_line_size / sizeof(T) : 1;
+    
+    auto scatter = [&](auto src, auto dst, size_t pass) {
+        auto body = [&, src, dst](size_t c) {
+            Histogram& next = offsets[c];
+            const size_t begin = chunk_begin(c);
+            const size_t end = chunk_end(c);
+            if constexpr (combine) {
+                auto& arena = this_worker::scratch();
+                auto mark = arena.mark();
+                T* lines = static_cast<T*>(arena.allocate(
+                    sizeof(T) * line * detail::radix_buckets, detail::cache_line_size));
+                std::array<uint8_t, detail::radix_buckets> fill{};
+                
+                for (size_t i = begin; i < end; ++i) {
+                    size_t b = digit(src[i], pass);
+                    T* slot = lines + b * line;
+                    new (slot + fill[b]) T(src[i]);
+                    if (++fill[b] == line) {
+                        std::copy(slot, slot + line, dst + static_cast<std::ptrdiff_t>(next[b]));
+                        next[b] += line;
+                        fill[b] = 0;
+                    }
+                }
+                for (size_t b = 0; b < detail::radix_buckets; ++b) {
+                    T* slot = lines + b * line;
+                    std::copy(slot, slot + fill[b], dst + static_cast<std::ptrdiff_t>(next[b]));
+                }
+                arena.release(mark);
+            } else {
+                for (size_t i = begin; i < end; ++i) {
+                    size_t b = digit(src[i], pass);
+                    dst[static_cast<std::ptrdiff_t>(next[b]++)] = std::move(src[i]);
+                }
+            }
+        };
+        detail::run_chunks(pool, chunks, body);
+    };
+    
+    bool in_buffer = false;
+    for (size_t k = 0; k < active.size(); ++k) {
+        const size_t pass = active[k];
+        
+        if (k == 0) {
+            for (size_t c = 0; c < chunks; ++c) {
+                histograms[c] = counts[c][pass];
+            }
+        } else {
+            auto body = [&](size_t c) {
+                Histogram& local = histograms[c];
+                local.fill(0);
+                for (size_t i = chunk_begin(c), end = chunk_end(c); i < end; ++i) {
+                    ++local[in_buffer ? digit(buffer[i], pass) : digit(first[i], pass)];
+                }
+            };
+            detail::run_chunks(pool, chunks, body);
+        }
+        
+        // Bucket-major exclusive scan: chunk c's run of digit b starts after
+        // every smaller digit and after earlier chunks' runs of b. There are
+        // only 256 x chunks entries, far below what a task costs to schedule.
+        size_t running = 0;
+        for (size_t b = 0; b < detail::radix_buckets; ++b) {
+            for (size_t c = 0; c < chunks; ++c) {
+                offsets[c][b] = running;
+                running += histograms[c][b];
+            }
+        }
+        
+        if (in_buffer) {
+            scatter(buffer.begin(), first, pass);
+        } else {
+            scatter(first, buffer.begin(), pass);
+        }
+        in_buffer = !in_buffer;
+    }
+    
+    if (in_buffer) {
+        auto body = [&](size_t c) {
+            auto begin = buffer.begin() + static_cast<std::ptrdiff_t>(chunk_begin(c));
+            auto end = buffer.begin() + static_cast<std::ptrdiff_t>(chunk_end(c));
+            std::move(begin, end, first + static_cast<std::ptrdiff_t>(chunk_begin(c)));
+        };
+        detail::run_chunks(pool, chunks, body);
+    }
+}
+
+/**
+ * @brief Sort a range of integers in ascending order
+ */
+template<typename RandomIt>
+void parallel_radix_sort(ThreadPool& pool, RandomIt first, RandomIt last,
+                         const RadixSortOptions& options = {})
+{
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    static_assert(std::is_integral_v<T>,
+                  "parallel_radix_sort: pass a key_fn for non-integral elements");
+    parallel_radix_sort(pool, first, last, [](const T& value) { return value; }, options);
+}
+
+} // namespace tp
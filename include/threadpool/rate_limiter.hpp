@@ -0,0 +1,265 @@
+#pragma once
+
+/**
+ * @file rate_limiter.hpp
+ * @brief Token-bucket rate limiting in front of a ThreadPool
+ * 
+ * Tasks wait in the limiter, not in the pool, and are handed to the pool as
+ * tokens accrue. When the bucket runs dry a single drain is scheduled with
+ * ThreadPool::submit_after() for the moment the next token is due, so no
+ * thread (worker or otherwise) ever sleeps to enforce the rate.
+ */
+
+#include "threadpool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace tp {
+
+/**
+ * @brief Releases tasks to a pool at no more than `rate` per second
+ * 
+ * Up to `burst` tasks may start back to back after an idle period. Queued
+ * tasks keep being released after the executor is destroyed; the pool must
+ * outlive them. ThreadPool::shutdown_now() drops them and breaks their futures.
+ * 
+ * @code
+ * tp::RateLimitedExecutor limiter(pool, 10.0, 5.0);   // 10/s, bursts of 5
+ * auto f = limiter.submit([] { return fetch(); });
+ * @endcode
+ */
+class RateLimitedExecutor {
+public:
+    /**
+     * @param rate Tokens added per second (must be > 0)
+     * @param burst Bucket capacity (must be >= 1); the bucket starts full
+     * @throws std::invalid_argument if rate is not positive or burst is below 1
+     */
+    RateLimitedExecutor(ThreadPool& pool, double rate, double burst = 1.0)
+        : state_(std::make_shared<State>(pool, rate, burst))
+    {}
+    
+    /**
+     * @brief Queue a task; it reaches the pool once a token is available
+     */
+    template<typename F, typename... Args>
+    auto submit(F&& func, Args&&... args)
+        -> std::future<std::invoke_result_t<F, Args...>>
+    {
+        using ReturnType = std::invoke_result_t<F, Args...>;
+        
+        auto task_ptr = std::make_shared<std::packaged_task<ReturnType()>>(
+            std::bind(std::forward<F>(func), std::forward<Args>(args)...)
+        );
+        std::future<ReturnType> result = task_ptr->get_future();
+        
+        {
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            state_->queue.emplace_back([task_ptr] { (*task_ptr)(); });
+        }
+        drain(state_);
+        return result;
+    }
+    
+    /**
+     * @brief Tasks waiting for a token
+     */
+    size_t queued() const {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        return state_->queue.size();
+    }
+    
+    double rate() const noexcept {
+        return state_->rate;
+    }
+    
+    double burst() const noexcept {
+        return state_->burst;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    
+    struct State {
+        State(ThreadPool& p, double r, double b)
+            : pool(p)
+            , rate(r > 0.0 ? r : throw std::invalid_argument("RateLimitedExecutor: rate must be > 0"))
+            , burst(b >= 1.0 ? b : throw std::invalid_argument("RateLimitedExecutor: burst must be >= 1"))
+            , tokens(burst)
+            , last_refill(Clock::now())
+        {}
+        
+        ThreadPool& pool;
+        const double rate;
+        const double burst;
+        
+        std::mutex mutex;
+        double tokens;
+        Clock::time_point last_refill;
+        std::deque<std::function<void()>> queue;
+        bool drain_scheduled = false;
+    };
+    
+    /**
+     * @brief The drain scheduled on the pool; drops the queue if never run
+     * 
+     * shutdown_now() discards delayed tasks unrun. Without a drain nothing
+     * would ever release or break the tasks still queued here.
+     */
+    class PendingDrain {
+    public:
+        explicit PendingDrain(std::shared_ptr<State> state)
+            : state_(std::move(state))
+        {}
+        
+        PendingDrain(PendingDrain&&) noexcept = default;
+        PendingDrain& operator=(PendingDrain&&) = delete;
+        
+        ~PendingDrain() {
+            if (!state_) {
+                return;
+            }
+            std::deque<std::function<void()>> dropped;
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            state_->drain_scheduled = false;
+            dropped.swap(state_->queue);
+        }
+        
+        void run() {
+            std::shared_ptr<State> state = std::move(state_);
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->drain_scheduled = false;
+            }
+            drain(state);
+        }
+        
+    private:
+        std::shared_ptr<State> state_;
+    };
+    
+    /**
+     * @brief Hand as many queued tasks to the pool as there are tokens
+     */
+    static void drain(const std::shared_ptr<State>& state) {
+        std::vector<std::function<void()>> released;
+        std::optional<std::chrono::nanoseconds> retry_in;
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            auto now = Clock::now();
+            double elapsed = std::chrono::duration<double>(now - state->last_refill).count();
+            state->tokens = std::min(state->burst, state->tokens + elapsed * state->rate);
+            state->last_refill = now;
+            
+            while (!state->queue.empty() && state->tokens >= 1.0) {
+                released.push_back(std::move(state->queue.front()));
+                state->queue.pop_front();
+                state->tokens -= 1.0;
+            }
+            
+            if (!state->queue.empty() && !state->drain_scheduled) {
+                state->drain_scheduled = true;
+                double wait = (1.0 - state->tokens) / state->rate;
+                retry_in = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::duration<double>(wait));
+            }
+        }
+        
+        // Submit outside the lock so the pool's queue lock never nests inside ours
+        try {
+            for (auto& task : released) {
+                state->pool.submit(std::move(task));
+            }
+            if (retry_in) {
+                state->pool.submit_after(*retry_in, [pending = PendingDrain(state)]() mutable {
+                    pending.run();
+                });
+            }
+        } catch (...) {
+            // Stopped pool: tasks not handed over are dropped (their futures
+            // break; a rejected drain drops the rest of the queue too), and
+            // the next submit() may schedule a drain again
+            if (retry_in) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->drain_scheduled = false;
+            }
+            throw;
+        }
+    }
+    
+    std::shared_ptr<State> state_;
+};
+
+/**
+ * @brief One independent token bucket per key (e.g. per host)
+ * 
+ * Buckets are created on first use with the rate and burst given here.
+ */
+template<typename Key, typename Hash = std::hash<Key>>
+class KeyedRateLimitedExecutor {
+public:
+    /**
+     * @throws std::invalid_argument if rate is not positive or burst is below 1
+     */
+    KeyedRateLimitedExecutor(ThreadPool& pool, double rate, double burst = 1.0)
+        : pool_(pool)
+        , rate_(rate > 0.0 ? rate : throw std::invalid_argument("KeyedRateLimitedExecutor: rate must be > 0"))
+        , burst_(burst >= 1.0 ? burst : throw std::invalid_argument("KeyedRateLimitedExecutor: burst must be >= 1"))
+    {}
+    
+    template<typename F, typename... Args>
+    auto submit(const Key& key, F&& func, Args&&... args)
+        -> std::future<std::invoke_result_t<F, Args...>>
+    {
+        return limiter(key).submit(std::forward<F>(func), std::forward<Args>(args)...);
+    }
+    
+    /**
+     * @brief Tasks waiting for a token across all keys
+     */
+    size_t queued() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t total = 0;
+        for (const auto& [key, limiter] : limiters_) {
+            total += limiter.queued();
+        }
+        return total;
+    }
+    
+    /**
+     * @brief Number of keys seen so far
+     */
+    size_t keys() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return limiters_.size();
+    }
+
+private:
+    RateLimitedExecutor& limiter(const Key& key) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = limiters_.find(key);
+        if (it == limiters_.end()) {
+            it = limiters_.emplace(key, RateLimitedExecutor(pool_, rate_, burst_)).first;
+        }
+        return it->second;
+    }
+    
+    ThreadPool& pool_;
+    const double rate_;
+    const double burst_;
+    
+    mutable std::mutex mutex_;
+    std::unordered_map<Key, RateLimitedExecutor, Hash> limiters_;
+};
+
+} // namespace tp
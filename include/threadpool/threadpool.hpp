@@ -10,9 +10,16 @@
  * - Work-stealing scheduling
  * - Typed futures for return values
  * - Priority task scheduling
+ * - Optional per-task CPU time sampling
+ * - Per-worker scratch arenas for task temporaries
+ * - Worker-local accumulators (WorkerLocal)
+ * - Per-worker fast random generators
+ * - Delayed task submission
+ * - Per-key concurrency limits
  * - Graceful shutdown
  */
 
+#include <algorithm>
 #include <thread>
 #include <vector>
 #include <queue>
@@ -21,13 +28,177 @@
 #include <mutex>
 #include <condition_variable>
 #include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <type_traits>
 #include <optional>
 #include <chrono>
+#include <deque>
+#include <map>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <time.h>
+#endif
+
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+#define THREADPOOL_HAS_THREAD_CPUTIME 1
+#endif
+
+#if defined(__has_include)
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#define THREADPOOL_HAS_PMR 1
+#endif
+#endif
+
+/**
+ * USDT static tracepoints (provider "threadpool") for bpftrace/perf.
+ * Define THREADPOOL_ENABLE_USDT to compile them in; each probe is a single
+ * NOP until a tracer attaches. Probe arguments are not evaluated otherwise.
+ */
+#if defined(THREADPOOL_ENABLE_USDT) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define THREADPOOL_HAS_USDT 1
+#endif
+#endif
+
+#if defined(THREADPOOL_HAS_USDT)
+#define THREADPOOL_PROBE1(name, a) DTRACE_PROBE1(threadpool, name, a)
+#define THREADPOOL_PROBE2(name, a, b) DTRACE_PROBE2(threadpool, name, a, b)
+#define THREADPOOL_PROBE3(name, a, b, c) DTRACE_PROBE3(threadpool, name, a, b, c)
+#else
+#define THREADPOOL_PROBE1(name, a) ((void)0)
+#define THREADPOOL_PROBE2(name, a, b) ((void)0)
+#define THREADPOOL_PROBE3(name, a, b, c) ((void)0)
+#endif
 
 namespace tp {
 
+namespace detail {
+
+/**
+ * @brief CPU time consumed by the calling thread
+ * 
+ * Returns zero on platforms without CLOCK_THREAD_CPUTIME_ID.
+ */
+inline std::chrono::nanoseconds thread_cpu_time() noexcept {
+#if defined(THREADPOOL_HAS_THREAD_CPUTIME)
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+#else
+    return std::chrono::nanoseconds{0};
+#endif
+}
+
+/**
+ * @brief Index of the pool worker running on this thread
+ */
+constexpr size_t no_worker = static_cast<size_t>(-1);
+inline thread_local size_t current_worker = no_worker;
+
+/**
+ * @brief Pool owning the worker running on this thread
+ */
+inline thread_local const void* current_pool = nullptr;
+
+/**
+ * @brief Padding unit used to keep per-worker data on separate cache lines
+ */
+constexpr size_t cache_line_size = 64;
+
+} // namespace detail
+
+/**
+ * @brief Acquisition and contention counters for one lock
+ */
+struct LockStats {
+    size_t acquisitions = 0;
+    size_t contended = 0;               // Acquisitions where try_lock failed
+    std::chrono::nanoseconds wait_time{0};  // Total time spent in the slow path
+    
+    /**
+     * @brief Fraction of acquisitions that had to wait
+     */
+    double contention_rate() const noexcept {
+        return acquisitions > 0 
+            ? static_cast<double>(contended) / static_cast<double>(acquisitions) 
+            : 0.0;
+    }
+};
+
+/**
+ * @brief std::mutex wrapper that can count contended acquisitions
+ * 
+ * When instrumentation is enabled, acquire() tries the lock first and only
+ * times the blocking slow path. Counters are updated while the lock is held,
+ * so the fast path adds no atomic read-modify-write. Re-acquisitions inside
+ * condition_variable::wait are not counted.
+ */
+class InstrumentedMutex {
+public:
+    InstrumentedMutex() = default;
+    
+    InstrumentedMutex(const InstrumentedMutex&) = delete;
+    InstrumentedMutex& operator=(const InstrumentedMutex&) = delete;
+    
+    /**
+     * @brief Lock the mutex, recording contention if enabled
+     */
+    std::unique_lock<std::mutex> acquire() {
+        if (!instrumented_.load(std::memory_order_relaxed)) {
+            return std::unique_lock<std::mutex>(mutex_);
+        }
+        
+        std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+        if (lock.owns_lock()) {
+            bump(acquisitions_, 1);
+            return lock;
+        }
+        
+        auto start = std::chrono::steady_clock::now();
+        lock.lock();
+        auto waited = std::chrono::steady_clock::now() - start;
+        
+        bump(acquisitions_, 1);
+        bump(contended_, 1);
+        bump(wait_ns_, static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(waited).count()));
+        return lock;
+    }
+    
+    void set_instrumented(bool enabled) noexcept {
+        instrumented_.store(enabled, std::memory_order_relaxed);
+    }
+    
+    bool instrumented() const noexcept {
+        return instrumented_.load(std::memory_order_relaxed);
+    }
+    
+    LockStats stats() const noexcept {
+        LockStats stats;
+        stats.acquisitions = static_cast<size_t>(acquisitions_.load(std::memory_order_relaxed));
+        stats.contended = static_cast<size_t>(contended_.load(std::memory_order_relaxed));
+        stats.wait_time = std::chrono::nanoseconds(wait_ns_.load(std::memory_order_relaxed));
+        return stats;
+    }
+
+private:
+    // Only called with mutex_ held, so a plain load/store is enough
+    static void bump(std::atomic<uint64_t>& counter, uint64_t amount) noexcept {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+    
+    std::mutex mutex_;
+    std::atomic<bool> instrumented_{false};
+    std::atomic<uint64_t> acquisitions_{0};
+    std::atomic<uint64_t> contended_{0};
+    std::atomic<uint64_t> wait_ns_{0};
+};
+
 /**
  * @brief Task wrapper with priority support
  */
@@ -36,9 +207,10 @@ public:
     Task() = default;
     
     template<typename F>
-    explicit Task(F&& func, int priority = 0)
+    explicit Task(F&& func, int priority = 0, uint64_t id = 0)
         : func_(std::forward<F>(func))
         , priority_(priority) 
+        , id_(id)
     {}
     
     void operator()() {
@@ -49,6 +221,8 @@ public:
     
     int priority() const noexcept { return priority_; }
     
+    uint64_t id() const noexcept { return id_; }
+    
     explicit operator bool() const noexcept { return static_cast<bool>(func_); }
     
     // Comparison for priority queue (lower priority value = higher priority)
@@ -59,13 +233,20 @@ public:
 private:
     std::function<void()> func_;
     int priority_ = 0;
+    uint64_t id_ = 0;
 };
 
 /**
  * @brief Thread-safe task queue with priority support
+ * 
+ * Tasks pushed with a due time wait in a timer heap and move to the ready
+ * queue once due; waiting workers sleep until the earliest due time, so no
+ * thread is dedicated to timers.
  */
 class TaskQueue {
 public:
+    using TimePoint = std::chrono::steady_clock::time_point;
+    
     TaskQueue() = default;
     
     // Non-copyable
@@ -77,17 +258,30 @@ public:
      */
     void push(Task task) {
         {
-            std::lock_guard<std::mutex> lock(mutex_);
+            auto lock = mutex_.acquire();
             queue_.push(std::move(task));
         }
         cv_.notify_one();
     }
     
+    /**
+     * @brief Push a task that becomes ready at the given time
+     */
+    void push_at(Task task, TimePoint due) {
+        {
+            auto lock = mutex_.acquire();
+            timers_.push(Timer{due, timer_sequence_++, std::move(task)});
+        }
+        // A waiter may need to shorten its sleep
+        cv_.notify_one();
+    }
+    
     /**
      * @brief Try to pop a task (non-blocking)
      */
     std::optional<Task> try_pop() {
-        std::lock_guard<std::mutex> lock(mutex_);
+        auto lock = mutex_.acquire();
+        promote_due_timers();
         if (queue_.empty()) {
             return std::nullopt;
         }
@@ -98,15 +292,33 @@ public:
     
     /**
      * @brief Wait and pop a task (blocking)
+     * 
+     * Returns nullopt once stop_flag is set and nothing is ready; delayed
+     * tasks still pending at that point are waited for. Also returns nullopt,
+     * once per call, for each wake_one().
      */
     std::optional<Task> wait_pop(std::atomic<bool>& stop_flag) {
-        std::unique_lock<std::mutex> lock(mutex_);
-        cv_.wait(lock, [this, &stop_flag] {
-            return !queue_.empty() || stop_flag.load(std::memory_order_acquire);
-        });
-        
-        if (queue_.empty()) {
-            return std::nullopt;
+        auto lock = mutex_.acquire();
+        while (true) {
+            promote_due_timers();
+            if (!queue_.empty()) {
+                break;
+            }
+            if (wakeups_ > 0) {
+                --wakeups_;
+                return std::nullopt;
+            }
+            if (stop_flag.load(std::memory_order_acquire) && timers_.empty()) {
+                return std::nullopt;
+            }
+            
+            THREADPOOL_PROBE1(park, detail::current_worker);
+            if (timers_.empty()) {
+                cv_.wait(lock);
+            } else {
+                cv_.wait_until(lock, timers_.top().due);
+            }
+            THREADPOOL_PROBE1(wake, detail::current_worker);
         }
         
         Task task = std::move(const_cast<Task&>(queue_.top()));
@@ -115,19 +327,27 @@ public:
     }
     
     /**
-     * @brief Get queue size
+     * @brief Get queue size (ready and delayed tasks)
      */
     size_t size() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return queue_.size();
+        auto lock = mutex_.acquire();
+        return queue_.size() + timers_.size();
+    }
+    
+    /**
+     * @brief Number of tasks waiting for their due time
+     */
+    size_t delayed() const {
+        auto lock = mutex_.acquire();
+        return timers_.size();
     }
     
     /**
      * @brief Check if queue is empty
      */
     bool empty() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return queue_.empty();
+        auto lock = mutex_.acquire();
+        return queue_.empty() && timers_.empty();
     }
     
     /**
@@ -137,20 +357,89 @@ public:
         cv_.notify_all();
     }
     
+    /**
+     * @brief Make one current or upcoming wait_pop() return empty-handed
+     * @param max_pending Cap on wakeups not yet consumed
+     * 
+     * Sends an idle worker to look for work outside this queue. A wakeup
+     * nobody is waiting for yet stays pending, so it cannot be lost.
+     */
+    void wake_one(size_t max_pending) {
+        {
+            auto lock = mutex_.acquire();
+            if (wakeups_ >= max_pending) {
+                return;
+            }
+            ++wakeups_;
+        }
+        cv_.notify_one();
+    }
+    
     /**
      * @brief Clear all pending tasks
      */
     void clear() {
-        std::lock_guard<std::mutex> lock(mutex_);
+        auto lock = mutex_.acquire();
         while (!queue_.empty()) {
             queue_.pop();
         }
+        while (!timers_.empty()) {
+            timers_.pop();
+        }
+    }
+    
+    /**
+     * @brief Enable or disable lock contention counters
+     */
+    void set_lock_instrumentation(bool enabled) noexcept {
+        mutex_.set_instrumented(enabled);
+    }
+    
+    /**
+     * @brief Get lock contention counters
+     */
+    LockStats lock_stats() const noexcept {
+        return mutex_.stats();
     }
 
 private:
-    mutable std::mutex mutex_;
+    struct Timer {
+        TimePoint due;
+        uint64_t sequence;  // FIFO among equal due times
+        Task task;
+        
+        // Min-heap on (due, sequence)
+        bool operator<(const Timer& other) const noexcept {
+            return due != other.due ? due > other.due : sequence > other.sequence;
+        }
+    };
+    
+    /**
+     * @brief Move due timers to the ready queue (lock held)
+     */
+    void promote_due_timers() {
+        if (timers_.empty()) {
+            return;
+        }
+        auto now = std::chrono::steady_clock::now();
+        size_t promoted = 0;
+        while (!timers_.empty() && timers_.top().due <= now) {
+            queue_.push(std::move(const_cast<Timer&>(timers_.top()).task));
+            timers_.pop();
+            ++promoted;
+        }
+        // The caller takes one; wake others for the rest
+        for (size_t i = 1; i < promoted; ++i) {
+            cv_.notify_one();
+        }
+    }
+    
+    mutable InstrumentedMutex mutex_;
     std::condition_variable cv_;
     std::priority_queue<Task> queue_;
+    std::priority_queue<Timer> timers_;
+    uint64_t timer_sequence_ = 0;
+    size_t wakeups_ = 0;
 };
 
 /**
@@ -164,7 +453,7 @@ public:
      * @brief Push task to front (owner thread)
      */
     void push_front(Task task) {
-        std::lock_guard<std::mutex> lock(mutex_);
+        auto lock = mutex_.acquire();
         deque_.push_front(std::move(task));
     }
     
@@ -172,7 +461,7 @@ public:
      * @brief Pop from front (owner thread)
      */
     std::optional<Task> pop_front() {
-        std::lock_guard<std::mutex> lock(mutex_);
+        auto lock = mutex_.acquire();
         if (deque_.empty()) {
             return std::nullopt;
         }
@@ -185,7 +474,7 @@ public:
      * @brief Steal from back (other threads)
      */
     std::optional<Task> steal() {
-        std::lock_guard<std::mutex> lock(mutex_);
+        auto lock = mutex_.acquire();
         if (deque_.empty()) {
             return std::nullopt;
         }
@@ -195,243 +484,915 @@ public:
     }
     
     size_t size() const {
-        std::lock_guard<std::mutex> lock(mutex_);
+        auto lock = mutex_.acquire();
         return deque_.size();
     }
     
     bool empty() const {
-        std::lock_guard<std::mutex> lock(mutex_);
+        auto lock = mutex_.acquire();
         return deque_.empty();
     }
+    
+    void set_lock_instrumentation(bool enabled) noexcept {
+        mutex_.set_instrumented(enabled);
+    }
+    
+    LockStats lock_stats() const noexcept {
+        return mutex_.stats();
+    }
 
 private:
-    mutable std::mutex mutex_;
+    mutable InstrumentedMutex mutex_;
     std::deque<Task> deque_;
 };
 
 /**
- * @brief Thread pool statistics
- */
-struct PoolStats {
-    size_t total_tasks_submitted = 0;
-    size_t total_tasks_completed = 0;
-    size_t total_tasks_stolen = 0;
-    std::chrono::nanoseconds total_execution_time{0};
-};
-
-/**
- * @brief Modern C++17 Thread Pool with work-stealing
+ * @brief xoshiro256** generator (UniformRandomBitGenerator)
  * 
- * Features:
- * - Configurable number of worker threads
- * - Work-stealing for load balancing
- * - Priority task scheduling
- * - Typed futures for return values
- * - Graceful shutdown
+ * 32 bytes of state and a handful of instructions per draw; seeded from a
+ * single 64-bit value through splitmix64. Not cryptographically secure.
  */
-class ThreadPool {
+class FastRng {
 public:
-    /**
-     * @brief Construct thread pool with specified number of threads
-     * @param num_threads Number of worker threads (default: hardware concurrency)
-     */
-    explicit ThreadPool(size_t num_threads = std::thread::hardware_concurrency())
-        : num_threads_(num_threads > 0 ? num_threads : 1)
-        , stop_(false)
-        , active_tasks_(0)
-    {
-        local_queues_.reserve(num_threads_);
-        workers_.reserve(num_threads_);
-        
-        for (size_t i = 0; i < num_threads_; ++i) {
-            local_queues_.push_back(std::make_unique<WorkStealingDeque>());
-        }
-        
-        for (size_t i = 0; i < num_threads_; ++i) {
-            workers_.emplace_back(&ThreadPool::worker_loop, this, i);
-        }
+    using result_type = uint64_t;
+    
+    explicit FastRng(uint64_t seed = 0) noexcept {
+        this->seed(seed);
     }
     
-    /**
-     * @brief Destructor - waits for all tasks to complete
-     */
-    ~ThreadPool() {
-        shutdown();
-        for (auto& worker : workers_) {
-            if (worker.joinable()) {
-                worker.join();
-            }
+    void seed(uint64_t seed) noexcept {
+        for (auto& word : state_) {
+            word = splitmix64(seed);
         }
     }
     
-    // Non-copyable, non-movable
-    ThreadPool(const ThreadPool&) = delete;
-    ThreadPool& operator=(const ThreadPool&) = delete;
-    ThreadPool(ThreadPool&&) = delete;
-    ThreadPool& operator=(ThreadPool&&) = delete;
-    
-    /**
-     * @brief Submit a task and get a future for the result
-     * @param func Callable to execute
-     * @param args Arguments to pass to the callable
-     * @return std::future for the result
-     */
-    template<typename F, typename... Args>
-    auto submit(F&& func, Args&&... args) 
-        -> std::future<std::invoke_result_t<F, Args...>> 
-    {
-        return submit_priority(0, std::forward<F>(func), std::forward<Args>(args)...);
-    }
+    static constexpr result_type min() noexcept { return 0; }
+    static constexpr result_type max() noexcept { return ~result_type(0); }
     
-    /**
-     * @brief Submit a task with priority
-     * @param priority Priority level (lower = higher priority)
-     * @param func Callable to execute
-     * @param args Arguments to pass to the callable
-     * @return std::future for the result
-     */
-    template<typename F, typename... Args>
-    auto submit_priority(int priority, F&& func, Args&&... args) 
-        -> std::future<std::invoke_result_t<F, Args...>> 
-    {
-        using ReturnType = std::invoke_result_t<F, Args...>;
-        
-        if (stop_.load(std::memory_order_acquire)) {
-            throw std::runtime_error("Cannot submit to stopped thread pool");
-        }
-        
-        auto task_ptr = std::make_shared<std::packaged_task<ReturnType()>>(
-            std::bind(std::forward<F>(func), std::forward<Args>(args)...)
-        );
-        
-        std::future<ReturnType> result = task_ptr->get_future();
-        
-        Task task([task_ptr]() { (*task_ptr)(); }, priority);
-        global_queue_.push(std::move(task));
-        
-        ++stats_.total_tasks_submitted;
-        
+    result_type operator()() noexcept {
+        const uint64_t result = rotl(state_[1] * 5, 7) * 9;
+        const uint64_t t = state_[1] << 17;
+        state_[2] ^= state_[0];
+        state_[3] ^= state_[1];
+        state_[1] ^= state_[2];
+        state_[0] ^= state_[3];
+        state_[2] ^= t;
+        state_[3] = rotl(state_[3], 45);
         return result;
     }
     
     /**
-     * @brief Get number of worker threads
+     * @brief Advance a splitmix64 state and return the next output
      */
-    size_t size() const noexcept {
-        return num_threads_;
+    static uint64_t splitmix64(uint64_t& x) noexcept {
+        uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+private:
+    static uint64_t rotl(uint64_t x, int k) noexcept {
+        return (x << k) | (x >> (64 - k));
     }
     
+    uint64_t state_[4];
+};
+
+/**
+ * @brief Per-thread bump allocator for task-local temporaries
+ * 
+ * Allocation is a pointer bump; deallocate() is a no-op. Pool workers rewind
+ * the arena after every task, so memory taken by a task is reclaimed when it
+ * returns. Tasks run nested through wait_helping() only rewind what they
+ * allocated themselves. When everything is released, overflow blocks are
+ * merged into one so steady-state use never touches malloc.
+ * 
+ * Usable as a std::pmr::memory_resource when <memory_resource> is available.
+ */
+class ScratchArena
+#if defined(THREADPOOL_HAS_PMR)
+    : public std::pmr::memory_resource
+#endif
+{
+public:
+    static constexpr size_t initial_block_size = 64 * 1024;
+    static constexpr size_t max_retained_size = 16 * 1024 * 1024;
+    
     /**
-     * @brief Get number of pending tasks
+     * @brief Position to rewind to with release()
      */
-    size_t pending() const noexcept {
-        size_t count = global_queue_.size();
-        for (const auto& q : local_queues_) {
-            count += q->size();
-        }
-        return count;
+    struct Mark {
+        size_t block = 0;
+        size_t offset = 0;
+    };
+    
+    ScratchArena() = default;
+    
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+    
+#if !defined(THREADPOOL_HAS_PMR)
+    [[nodiscard]] void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+        return bump(bytes, alignment);
     }
     
+    void deallocate(void*, size_t, size_t = alignof(std::max_align_t)) noexcept {}
+#endif
+    
     /**
-     * @brief Get number of actively executing tasks
+     * @brief Current allocation position
      */
-    size_t active() const noexcept {
-        return active_tasks_.load(std::memory_order_relaxed);
+    Mark mark() const noexcept {
+        return {current_, offset_};
     }
     
     /**
-     * @brief Wait for all submitted tasks to complete
+     * @brief Free everything allocated since the mark was taken
      */
-    void wait() {
-        while (pending() > 0 || active() > 0) {
-            std::this_thread::sleep_for(std::chrono::microseconds(100));
+    void release(Mark mark) noexcept {
+        if (mark.block == current_ && mark.offset == offset_) {
+            return;
+        }
+        current_ = mark.block;
+        offset_ = mark.offset;
+        if (current_ == 0 && offset_ == 0) {
+            consolidate();
         }
     }
     
     /**
-     * @brief Stop accepting new tasks and wait for completion
+     * @brief Free everything
      */
-    void shutdown() {
-        stop_.store(true, std::memory_order_release);
-        global_queue_.notify_all();
+    void reset() noexcept {
+        release(Mark{});
     }
     
     /**
-     * @brief Stop and cancel all pending tasks
+     * @brief Bytes handed out since the last reset (including alignment padding)
      */
-    void shutdown_now() {
-        stop_.store(true, std::memory_order_release);
-        global_queue_.clear();
-        for (auto& q : local_queues_) {
-            while (q->pop_front().has_value()) {}
+    size_t used() const noexcept {
+        size_t total = offset_;
+        for (size_t i = 0; i < current_ && i < blocks_.size(); ++i) {
+            total += blocks_[i].size;
         }
-        global_queue_.notify_all();
+        return total;
     }
     
     /**
-     * @brief Get pool statistics
+     * @brief Bytes held in blocks
      */
-    PoolStats stats() const {
-        return stats_;
+    size_t capacity() const noexcept {
+        size_t total = 0;
+        for (const auto& block : blocks_) {
+            total += block.size;
+        }
+        return total;
+    }
+
+protected:
+#if defined(THREADPOOL_HAS_PMR)
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        return bump(bytes, alignment);
+    }
+    
+    void do_deallocate(void*, size_t, size_t) override {}
+    
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
     }
+#endif
 
 private:
-    /**
-     * @brief Worker thread main loop
-     */
-    void worker_loop(size_t worker_id) {
+    struct Block {
+        std::unique_ptr<unsigned char[]> data;
+        size_t size = 0;
+    };
+    
+    void* bump(size_t bytes, size_t alignment) {
         while (true) {
-            std::optional<Task> task;
-            
-            // 1. Try local queue first
-            task = local_queues_[worker_id]->pop_front();
+            if (current_ < blocks_.size()) {
+                Block& block = blocks_[current_];
+                auto base = reinterpret_cast<uintptr_t>(block.data.get());
+                uintptr_t aligned = (base + offset_ + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+                size_t end = static_cast<size_t>(aligned - base) + bytes;
+                if (end <= block.size) {
+                    offset_ = end;
+                    return reinterpret_cast<void*>(aligned);
+                }
+                // Move on to the next retained block, or grow
+                if (current_ + 1 < blocks_.size() && bytes + alignment <= blocks_[current_ + 1].size) {
+                    ++current_;
+                    offset_ = 0;
+                    continue;
+                }
+            }
             
-            // 2. Try global queue
-            if (!task) {
-                task = global_queue_.try_pop();
+            size_t size = blocks_.empty() ? initial_block_size : blocks_.back().size * 2;
+            size = std::max(size, bytes + alignment);
+            
+            // Drop retained blocks past the current one that were too small
+            if (current_ + 1 < blocks_.size()) {
+                blocks_.resize(current_ + 1);
             }
+            blocks_.push_back(Block{std::unique_ptr<unsigned char[]>(new unsigned char[size]), size});
+            current_ = blocks_.size() - 1;
+            offset_ = 0;
+        }
+    }
+    
+    /**
+     * @brief Merge overflow blocks into one once the arena is empty
+     */
+    void consolidate() noexcept {
+        if (blocks_.size() <= 1) {
+            return;
+        }
+        size_t size = std::min(capacity(), max_retained_size);
+        blocks_.clear();
+        try {
+            blocks_.push_back(Block{std::unique_ptr<unsigned char[]>(new unsigned char[size]), size});
+        } catch (...) {
+            // Allocate lazily on next use instead
+        }
+    }
+    
+    std::vector<Block> blocks_;
+    size_t current_ = 0;   // Index of the block being bumped
+    size_t offset_ = 0;    // Bytes used in that block
+};
+
+namespace detail {
+
+inline ScratchArena& scratch_arena() noexcept {
+    static thread_local ScratchArena arena;
+    return arena;
+}
+
+/**
+ * @brief Seed for a thread's generator: distinct across threads and runs
+ */
+inline uint64_t thread_rng_seed() noexcept {
+    static std::atomic<uint64_t> sequence{0};
+    uint64_t x = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count())
+               ^ (sequence.fetch_add(1, std::memory_order_relaxed) << 32)
+               ^ static_cast<uint64_t>(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    return FastRng::splitmix64(x);
+}
+
+inline FastRng& thread_rng() noexcept {
+    static thread_local FastRng rng(thread_rng_seed());
+    return rng;
+}
+
+/**
+ * @brief Seed of the stream for one task under PoolConfig::rng_seed
+ */
+inline uint64_t task_rng_seed(uint64_t seed, uint64_t task_id) noexcept {
+    uint64_t x = seed ^ FastRng::splitmix64(task_id);
+    return FastRng::splitmix64(x);
+}
+
+} // namespace detail
+
+/**
+ * @brief Facilities for code running inside a pool task
+ */
+namespace this_worker {
+
+/**
+ * @brief The calling thread's scratch arena
+ * 
+ * On pool workers the arena is rewound after each task, so anything
+ * allocated from it must not outlive the task. On other threads it is only
+ * freed by an explicit reset().
+ * 
+ * @code
+ * std::pmr::vector<double> tmp(&tp::this_worker::scratch());
+ * @endcode
+ */
+inline ScratchArena& scratch() noexcept {
+    return detail::scratch_arena();
+}
+
+/**
+ * @brief The calling thread's random generator
+ * 
+ * Seeded once per thread. With PoolConfig::rng_seed set, each task instead
+ * sees its own stream derived from the seed and the task id, so runs that
+ * submit tasks in the same order draw the same numbers.
+ * 
+ * @code
+ * std::uniform_int_distribution<int> dist(1, 6);
+ * int roll = dist(tp::this_worker::rng());
+ * @endcode
+ */
+inline FastRng& rng() noexcept {
+    return detail::thread_rng();
+}
+
+/**
+ * @brief Index of the calling pool worker, or nullopt outside any pool
+ */
+inline std::optional<size_t> id() noexcept {
+    if (detail::current_pool == nullptr) {
+        return std::nullopt;
+    }
+    return detail::current_worker;
+}
+
+} // namespace this_worker
+
+/**
+ * @brief CPU vs wall time for all tasks sharing a tag
+ * 
+ * Only collected when PoolConfig::sample_cpu_time is enabled.
+ */
+struct TagStats {
+    size_t tasks = 0;
+    size_t blocking_tasks = 0;  // Tasks whose CPU/wall ratio fell below the threshold
+    std::chrono::nanoseconds wall_time{0};
+    std::chrono::nanoseconds cpu_time{0};
+    double blocking_threshold = 0.5;  // PoolConfig::blocking_threshold of the pool
+    
+    /**
+     * @brief Fraction of wall time spent on-CPU (1.0 = never blocked)
+     */
+    double cpu_ratio() const noexcept {
+        if (wall_time.count() <= 0) {
+            return 1.0;
+        }
+        return static_cast<double>(cpu_time.count()) / static_cast<double>(wall_time.count());
+    }
+    
+    /**
+     * @brief Whether tasks with this tag look I/O- or lock-bound
+     */
+    bool likely_blocking() const noexcept {
+        return likely_blocking(blocking_threshold);
+    }
+    
+    /**
+     * @brief Same, against an explicit CPU/wall threshold
+     */
+    bool likely_blocking(double threshold) const noexcept {
+        return tasks > 0 && cpu_ratio() < threshold;
+    }
+};
+
+/**
+ * @brief Thread pool statistics
+ */
+struct PoolStats {
+    size_t total_tasks_submitted = 0;
+    size_t total_tasks_completed = 0;
+    size_t total_tasks_stolen = 0;
+    std::chrono::nanoseconds total_execution_time{0};
+    std::chrono::nanoseconds total_cpu_time{0};
+    
+    // Per-tag CPU/wall breakdown; untagged tasks are grouped under ""
+    std::map<std::string, TagStats> tags;
+    
+    // Queue lock contention (zero unless PoolConfig::instrument_locks is set)
+    LockStats global_queue_lock;
+    std::vector<LockStats> local_queue_locks;  // One entry per worker
+};
+
+/**
+ * @brief Thread pool construction options
+ */
+struct PoolConfig {
+    size_t num_threads = std::thread::hardware_concurrency();
+    
+    // Sample CLOCK_THREAD_CPUTIME_ID around every task to detect blocking.
+    // Ignored on platforms without per-thread CPU clocks.
+    bool sample_cpu_time = false;
+    
+    // Tasks below this CPU/wall ratio are counted as blocking
+    double blocking_threshold = 0.5;
+    
+    // Count acquisitions, contended acquisitions and wait time on queue locks
+    bool instrument_locks = false;
+    
+    // Run on each worker thread before its first task and after its last;
+    // use for per-thread resources. Must not throw.
+    std::function<void(size_t worker_id)> on_worker_start{};
+    std::function<void(size_t worker_id)> on_worker_stop{};
+    
+    // When set, this_worker::rng() is reseeded from (rng_seed, task id)
+    // before every task, giving reproducible per-task random streams
+    std::optional<uint64_t> rng_seed{};
+};
+
+class ThreadPool;
+class LimitedExecutor;
+
+namespace detail {
+
+/**
+ * @brief Shared state of one concurrency lane (see ThreadPool::limited)
+ */
+struct LaneState {
+    std::mutex mutex;
+    size_t limit = 1;
+    size_t running = 0;
+    std::deque<std::function<void()>> waiting;
+};
+
+} // namespace detail
+
+/**
+ * @brief Modern C++17 Thread Pool with work-stealing
+ * 
+ * Features:
+ * - Configurable number of worker threads
+ * - Work-stealing for load balancing
+ * - Priority task scheduling
+ * - Typed futures for return values
+ * - Graceful shutdown
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Construct thread pool with specified number of threads
+     * @param num_threads Number of worker threads (default: hardware concurrency)
+     */
+    explicit ThreadPool(size_t num_threads = std::thread::hardware_concurrency())
+        : ThreadPool(PoolConfig{num_threads})
+    {}
+    
+    /**
+     * @brief Construct thread pool from a configuration
+     * @param config Pool options (thread count, instrumentation)
+     */
+    explicit ThreadPool(const PoolConfig& config)
+        : config_(config)
+        , num_threads_(config.num_threads > 0 ? config.num_threads : 1)
+        , stop_(false)
+        , active_tasks_(0)
+    {
+#if !defined(THREADPOOL_HAS_THREAD_CPUTIME)
+        config_.sample_cpu_time = false;
+#endif
+
+        local_queues_.reserve(num_threads_);
+        workers_.reserve(num_threads_);
+        
+        for (size_t i = 0; i < num_threads_; ++i) {
+            local_queues_.push_back(std::make_unique<WorkStealingDeque>());
+            local_queues_.back()->set_lock_instrumentation(config_.instrument_locks);
+        }
+        global_queue_.set_lock_instrumentation(config_.instrument_locks);
+        
+        for (size_t i = 0; i < num_threads_; ++i) {
+            workers_.emplace_back(&ThreadPool::worker_loop, this, i);
+        }
+    }
+    
+    /**
+     * @brief Destructor - waits for all tasks to complete
+     */
+    ~ThreadPool() {
+        shutdown();
+        for (auto& worker : workers_) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+    }
+    
+    // Non-copyable, non-movable
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ThreadPool(ThreadPool&&) = delete;
+    ThreadPool& operator=(ThreadPool&&) = delete;
+    
+    /**
+     * @brief Submit a task and get a future for the result
+     * @param func Callable to execute
+     * @param args Arguments to pass to the callable
+     * @return std::future for the result
+     */
+    template<typename F, typename... Args>
+    auto submit(F&& func, Args&&... args) 
+        -> std::future<std::invoke_result_t<F, Args...>> 
+    {
+        return submit_priority(0, std::forward<F>(func), std::forward<Args>(args)...);
+    }
+    
+    /**
+     * @brief Submit a task with priority
+     * @param priority Priority level (lower = higher priority)
+     * @param func Callable to execute
+     * @param args Arguments to pass to the callable
+     * @return std::future for the result
+     */
+    template<typename F, typename... Args>
+    auto submit_priority(int priority, F&& func, Args&&... args) 
+        -> std::future<std::invoke_result_t<F, Args...>> 
+    {
+        return enqueue(priority, std::string(), std::nullopt, std::forward<F>(func), std::forward<Args>(args)...);
+    }
+    
+    /**
+     * @brief Submit a task whose CPU/wall time is reported under a tag
+     * @param tag Name used to group the task in PoolStats::tags
+     * @param func Callable to execute
+     * @param args Arguments to pass to the callable
+     * @return std::future for the result
+     */
+    template<typename F, typename... Args>
+    auto submit_tagged(std::string tag, F&& func, Args&&... args) 
+        -> std::future<std::invoke_result_t<F, Args...>> 
+    {
+        return enqueue(0, std::move(tag), std::nullopt, std::forward<F>(func), std::forward<Args>(args)...);
+    }
+    
+    /**
+     * @brief Submit a task that becomes runnable after a delay
+     * @param delay Time to wait before the task is queued for a worker
+     * @param func Callable to execute
+     * @param args Arguments to pass to the callable
+     * @return std::future for the result
+     * 
+     * No thread sleeps for the delay: idle workers wait on the queue until
+     * the earliest due time. Graceful shutdown still runs delayed tasks.
+     */
+    template<typename Rep, typename Period, typename F, typename... Args>
+    auto submit_after(std::chrono::duration<Rep, Period> delay, F&& func, Args&&... args) 
+        -> std::future<std::invoke_result_t<F, Args...>> 
+    {
+        return submit_at(std::chrono::steady_clock::now() + delay, 
+                         std::forward<F>(func), std::forward<Args>(args)...);
+    }
+    
+    /**
+     * @brief Submit a task that becomes runnable at a point in time
+     */
+    template<typename F, typename... Args>
+    auto submit_at(std::chrono::steady_clock::time_point when, F&& func, Args&&... args) 
+        -> std::future<std::invoke_result_t<F, Args...>> 
+    {
+        return enqueue(0, std::string(), when, std::forward<F>(func), std::forward<Args>(args)...);
+    }
+    
+    /**
+     * @brief Submitter whose tasks share a concurrency limit per key
+     * @param key Lane name; calls with the same key share one lane
+     * @param max_concurrency Tasks of this lane allowed to run at once
+     *        (the latest call sets the lane's limit)
+     * 
+     * Tasks beyond the limit wait in the lane, outside the pool, and are
+     * released as running ones finish, so no worker blocks on the limit.
+     * 
+     * @code
+     * pool.limited("db", 4).submit([] { query(); });
+     * @endcode
+     */
+    LimitedExecutor limited(const std::string& key, size_t max_concurrency);
+    
+    /**
+     * @brief Get number of worker threads
+     */
+    size_t size() const noexcept {
+        return num_threads_;
+    }
+    
+    /**
+     * @brief Get number of pending tasks (including delayed ones)
+     */
+    size_t pending() const noexcept {
+        size_t count = global_queue_.size();
+        for (const auto& q : local_queues_) {
+            count += q->size();
+        }
+        return count;
+    }
+    
+    /**
+     * @brief Get number of actively executing tasks
+     */
+    size_t active() const noexcept {
+        return active_tasks_.load(std::memory_order_relaxed);
+    }
+    
+    /**
+     * @brief Wait for all submitted tasks to complete
+     */
+    void wait() {
+        while (pending() > 0 || active() > 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+    
+    /**
+     * @brief Run one pending task on the calling thread
+     * @return true if a task was executed
+     * 
+     * Callable from workers and external threads alike.
+     */
+    bool run_pending_task() {
+        size_t worker_id = local_worker_index();
+        std::optional<Task> task = find_task(worker_id);
+        if (!task) {
+            return false;
+        }
+        execute(*task, worker_id);
+        return true;
+    }
+    
+    /**
+     * @brief Wait for a future, running pending tasks in the meantime
+     * 
+     * Use this instead of future.wait() when a task waits on tasks it
+     * submitted (fork-join); a blocking wait can leave every worker waiting
+     * on children that no worker is free to run.
+     */
+    template<typename T>
+    void wait_helping(const std::future<T>& future) {
+        while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            if (!run_pending_task()) {
+                std::this_thread::yield();
+            }
+        }
+    }
+    
+    /**
+     * @brief Stop accepting new tasks and wait for completion
+     * 
+     * Queued and delayed tasks still run. Until they have drained, tasks
+     * running on this pool's workers may keep submitting (continuations,
+     * delayed retries); any other thread gets std::runtime_error.
+     */
+    void shutdown() {
+        stop_.store(true, std::memory_order_release);
+        global_queue_.notify_all();
+    }
+    
+    /**
+     * @brief Stop and cancel all pending tasks
+     * 
+     * Queued and delayed tasks are discarded and every later submit throws,
+     * including from tasks still running on the workers.
+     */
+    void shutdown_now() {
+        cancelled_.store(true, std::memory_order_release);
+        stop_.store(true, std::memory_order_release);
+        global_queue_.clear();
+        for (auto& q : local_queues_) {
+            while (q->pop_front().has_value()) {}
+        }
+        global_queue_.notify_all();
+    }
+    
+    /**
+     * @brief Get pool statistics
+     */
+    PoolStats stats() const {
+        PoolStats stats;
+        stats.total_tasks_submitted = tasks_submitted_.load(std::memory_order_relaxed);
+        stats.total_tasks_completed = tasks_completed_.load(std::memory_order_relaxed);
+        stats.total_tasks_stolen = tasks_stolen_.load(std::memory_order_relaxed);
+        stats.total_execution_time = std::chrono::nanoseconds(execution_ns_.load(std::memory_order_relaxed));
+        stats.total_cpu_time = std::chrono::nanoseconds(cpu_ns_.load(std::memory_order_relaxed));
+        
+        stats.global_queue_lock = global_queue_.lock_stats();
+        stats.local_queue_locks.reserve(local_queues_.size());
+        for (const auto& q : local_queues_) {
+            stats.local_queue_locks.push_back(q->lock_stats());
+        }
+        
+        std::lock_guard<std::mutex> lock(tag_mutex_);
+        stats.tags = tag_stats_;
+        return stats;
+    }
+
+private:
+    using Clock = std::chrono::high_resolution_clock;
+    
+    /**
+     * @brief Measures one task execution
+     * 
+     * Lives inside the packaged task so that the accounting is published
+     * before the task's future becomes ready.
+     */
+    class ExecutionTimer {
+    public:
+        ExecutionTimer(ThreadPool& pool, const std::string& tag)
+            : pool_(pool)
+            , tag_(tag)
+            , wall_start_(Clock::now())
+            , cpu_start_(pool.config_.sample_cpu_time ? detail::thread_cpu_time() : std::chrono::nanoseconds{0})
+        {}
+        
+        ~ExecutionTimer() {
+            auto wall = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - wall_start_);
+            auto cpu = pool_.config_.sample_cpu_time 
+                ? detail::thread_cpu_time() - cpu_start_ 
+                : std::chrono::nanoseconds{0};
+            pool_.record_execution(tag_, wall, cpu);
+        }
+        
+        ExecutionTimer(const ExecutionTimer&) = delete;
+        ExecutionTimer& operator=(const ExecutionTimer&) = delete;
+        
+    private:
+        ThreadPool& pool_;
+        const std::string& tag_;
+        Clock::time_point wall_start_;
+        std::chrono::nanoseconds cpu_start_;
+    };
+    
+    /**
+     * @brief Wrap a callable in a packaged task and queue it
+     * @param due When set, the task is held until this time
+     */
+    template<typename F, typename... Args>
+    auto enqueue(int priority, std::string tag, std::optional<TaskQueue::TimePoint> due, 
+                 F&& func, Args&&... args) 
+        -> std::future<std::invoke_result_t<F, Args...>> 
+    {
+        using ReturnType = std::invoke_result_t<F, Args...>;
+        
+        // Running tasks may still submit while a graceful shutdown drains,
+        // but not once shutdown_now() has cancelled everything
+        if (cancelled_.load(std::memory_order_acquire) ||
+            (stop_.load(std::memory_order_acquire) && local_worker_index() == detail::no_worker)) {
+            throw std::runtime_error("Cannot submit to stopped thread pool");
+        }
+        
+        auto bound = std::bind(std::forward<F>(func), std::forward<Args>(args)...);
+        auto task_ptr = std::make_shared<std::packaged_task<ReturnType()>>(
+            [this, bound = std::move(bound), tag = std::move(tag)]() mutable -> ReturnType {
+                ExecutionTimer timer(*this, tag);
+                return bound();
+            }
+        );
+        
+        std::future<ReturnType> result = task_ptr->get_future();
+        
+        uint64_t id = tasks_submitted_.fetch_add(1, std::memory_order_relaxed) + 1;
+        THREADPOOL_PROBE2(submit, id, priority);
+        
+        Task task([task_ptr]() { (*task_ptr)(); }, priority, id);
+        size_t worker_id = local_worker_index();
+        if (due) {
+            global_queue_.push_at(std::move(task), *due);
+        } else if (worker_id != detail::no_worker && priority == 0) {
+            // Children of a running task stay on its worker (LIFO) for idle
+            // workers to steal; prioritized tasks keep global ordering
+            local_queues_[worker_id]->push_front(std::move(task));
+            if (size_t idle = idle_workers_.load(std::memory_order_seq_cst); idle > 0) {
+                global_queue_.wake_one(idle);
+            }
+        } else {
+            global_queue_.push(std::move(task));
+        }
+        
+        return result;
+    }
+    
+    /**
+     * @brief Record the wall (and optionally CPU) time of a finished task
+     */
+    void record_execution(const std::string& tag, 
+                          std::chrono::nanoseconds wall, 
+                          std::chrono::nanoseconds cpu) {
+        execution_ns_.fetch_add(wall.count(), std::memory_order_relaxed);
+        
+        if (config_.sample_cpu_time) {
+            cpu_ns_.fetch_add(cpu.count(), std::memory_order_relaxed);
             
-            // 3. Try stealing from other workers
-            if (!task) {
-                task = try_steal(worker_id);
+            std::lock_guard<std::mutex> lock(tag_mutex_);
+            TagStats& entry = tag_stats_[tag];
+            entry.blocking_threshold = config_.blocking_threshold;
+            ++entry.tasks;
+            entry.wall_time += wall;
+            entry.cpu_time += cpu;
+            if (wall.count() > 0 && 
+                static_cast<double>(cpu.count()) < config_.blocking_threshold * static_cast<double>(wall.count())) {
+                ++entry.blocking_tasks;
             }
+        }
+        
+        tasks_completed_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Worker thread main loop
+     */
+    void worker_loop(size_t worker_id) {
+        detail::current_pool = this;
+        detail::current_worker = worker_id;
+        
+        if (config_.on_worker_start) {
+            config_.on_worker_start(worker_id);
+        }
+        
+        while (true) {
+            // 1-3. Local queue, global queue, then stealing
+            std::optional<Task> task = find_task(worker_id);
             
-            // 4. Wait on global queue
+            // 4. Wait on global queue. Announce the wait before looking once
+            // more, so a worker pushing to its deque either sees us idle and
+            // wakes us, or pushed early enough for the second look to steal.
             if (!task) {
-                task = global_queue_.wait_pop(stop_);
+                idle_workers_.fetch_add(1, std::memory_order_seq_cst);
+                task = find_task(worker_id);
+                if (!task) {
+                    task = global_queue_.wait_pop(stop_);
+                }
+                idle_workers_.fetch_sub(1, std::memory_order_relaxed);
             }
             
             if (!task) {
-                if (stop_.load(std::memory_order_acquire)) {
+                // Other workers' deques may still hold work to steal
+                if (stop_.load(std::memory_order_acquire) && pending() == 0) {
                     break;
                 }
                 continue;
             }
             
-            // Execute task
-            ++active_tasks_;
-            auto start = std::chrono::high_resolution_clock::now();
-            
-            (*task)();
-            
-            auto end = std::chrono::high_resolution_clock::now();
-            stats_.total_execution_time += (end - start);
-            ++stats_.total_tasks_completed;
-            --active_tasks_;
+            execute(*task, worker_id);
+        }
+        
+        if (config_.on_worker_stop) {
+            config_.on_worker_stop(worker_id);
         }
     }
     
+    /**
+     * @brief Look for runnable work without blocking
+     * @param worker_id Caller's worker index, or detail::no_worker
+     */
+    std::optional<Task> find_task(size_t worker_id) {
+        std::optional<Task> task;
+        
+        if (worker_id != detail::no_worker) {
+            task = local_queues_[worker_id]->pop_front();
+        }
+        
+        if (!task) {
+            task = global_queue_.try_pop();
+        }
+        
+        if (!task) {
+            task = try_steal(worker_id);
+        }
+        
+        return task;
+    }
+    
+    /**
+     * @brief Run a dequeued task on the calling thread
+     */
+    void execute(Task& task, [[maybe_unused]] size_t worker_id) {
+        THREADPOOL_PROBE3(dequeue, task.id(), task.priority(), worker_id);
+        
+        // Timing is recorded by the task itself
+        ScratchArena& scratch = detail::scratch_arena();
+        ScratchArena::Mark mark = scratch.mark();
+        
+        // A nested task must not disturb the stream of the task it runs inside
+        std::optional<FastRng> saved_rng;
+        if (config_.rng_seed) {
+            FastRng& rng = detail::thread_rng();
+            saved_rng = rng;
+            rng.seed(detail::task_rng_seed(*config_.rng_seed, task.id()));
+        }
+        
+        ++active_tasks_;
+        THREADPOOL_PROBE2(start, task.id(), worker_id);
+        task();
+        THREADPOOL_PROBE2(finish, task.id(), worker_id);
+        --active_tasks_;
+        
+        if (saved_rng) {
+            detail::thread_rng() = *saved_rng;
+        }
+        scratch.release(mark);
+    }
+    
+    /**
+     * @brief Worker index of the calling thread in this pool, or detail::no_worker
+     */
+    size_t local_worker_index() const noexcept {
+        return detail::current_pool == this ? detail::current_worker : detail::no_worker;
+    }
+    
     /**
      * @brief Try to steal a task from another worker
      */
     std::optional<Task> try_steal(size_t worker_id) {
+        size_t first = worker_id == detail::no_worker ? 0 : worker_id + 1;
         for (size_t i = 0; i < num_threads_; ++i) {
-            size_t victim = (worker_id + i + 1) % num_threads_;
+            size_t victim = (first + i) % num_threads_;
             if (victim == worker_id) continue;
             
             auto task = local_queues_[victim]->steal();
             if (task) {
-                ++stats_.total_tasks_stolen;
+                THREADPOOL_PROBE3(steal, task->id(), worker_id, victim);
+                tasks_stolen_.fetch_add(1, std::memory_order_relaxed);
                 return task;
             }
         }
@@ -439,17 +1400,340 @@ private:
     }
 
 private:
+    PoolConfig config_;
     size_t num_threads_;
     std::atomic<bool> stop_;
+    std::atomic<bool> cancelled_{false};
     std::atomic<size_t> active_tasks_;
+    std::atomic<size_t> idle_workers_{0};  // Workers in (or about to enter) wait_pop
     
     TaskQueue global_queue_;
     std::vector<std::unique_ptr<WorkStealingDeque>> local_queues_;
     std::vector<std::thread> workers_;
     
-    mutable PoolStats stats_;
+    // Statistics
+    std::atomic<size_t> tasks_submitted_{0};
+    std::atomic<size_t> tasks_completed_{0};
+    std::atomic<size_t> tasks_stolen_{0};
+    std::atomic<int64_t> execution_ns_{0};
+    std::atomic<int64_t> cpu_ns_{0};
+    
+    mutable std::mutex tag_mutex_;
+    std::map<std::string, TagStats> tag_stats_;
+    
+    std::mutex lanes_mutex_;
+    std::map<std::string, std::shared_ptr<detail::LaneState>> lanes_;
+};
+
+/**
+ * @brief Submits into one concurrency lane of a pool
+ * 
+ * Obtained from ThreadPool::limited(); cheap to copy. All copies and all
+ * submitters for the same key share the lane.
+ */
+class LimitedExecutor {
+public:
+    LimitedExecutor(ThreadPool& pool, std::shared_ptr<detail::LaneState> lane)
+        : pool_(&pool)
+        , lane_(std::move(lane))
+    {}
+    
+    /**
+     * @brief Run the task now if the lane has room, otherwise queue it in the lane
+     */
+    template<typename F, typename... Args>
+    auto submit(F&& func, Args&&... args) 
+        -> std::future<std::invoke_result_t<F, Args...>> 
+    {
+        using ReturnType = std::invoke_result_t<F, Args...>;
+        
+        // The slot is handed on inside the task, before its future is ready
+        auto bound = std::bind(std::forward<F>(func), std::forward<Args>(args)...);
+        auto task_ptr = std::make_shared<std::packaged_task<ReturnType()>>(
+            [pool = pool_, lane = lane_, bound = std::move(bound)]() mutable -> ReturnType {
+                SlotRelease release(*pool, lane);
+                return bound();
+            }
+        );
+        std::future<ReturnType> result = task_ptr->get_future();
+        std::function<void()> job = [task_ptr] { (*task_ptr)(); };
+        
+        {
+            std::lock_guard<std::mutex> lock(lane_->mutex);
+            if (lane_->running >= lane_->limit) {
+                lane_->waiting.push_back(std::move(job));
+                return result;
+            }
+            ++lane_->running;
+        }
+        try {
+            pool_->submit(std::move(job));
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(lane_->mutex);
+            --lane_->running;
+            throw;
+        }
+        return result;
+    }
+    
+    /**
+     * @brief Tasks of this lane currently running
+     */
+    size_t running() const {
+        std::lock_guard<std::mutex> lock(lane_->mutex);
+        return lane_->running;
+    }
+    
+    /**
+     * @brief Tasks of this lane waiting for a free slot
+     */
+    size_t queued() const {
+        std::lock_guard<std::mutex> lock(lane_->mutex);
+        return lane_->waiting.size();
+    }
+    
+    size_t max_concurrency() const {
+        std::lock_guard<std::mutex> lock(lane_->mutex);
+        return lane_->limit;
+    }
+
+private:
+    /**
+     * @brief Passes a finished task's slot to the next waiter, or frees it
+     */
+    class SlotRelease {
+    public:
+        SlotRelease(ThreadPool& pool, const std::shared_ptr<detail::LaneState>& lane)
+            : pool_(pool)
+            , lane_(lane)
+        {}
+        
+        ~SlotRelease() {
+            std::function<void()> next;
+            {
+                std::lock_guard<std::mutex> lock(lane_->mutex);
+                if (!lane_->waiting.empty() && lane_->running <= lane_->limit) {
+                    next = std::move(lane_->waiting.front());
+                    lane_->waiting.pop_front();
+                } else {
+                    --lane_->running;
+                }
+            }
+            if (next) {
+                try {
+                    pool_.submit(std::move(next));
+                } catch (...) {
+                    // The pool no longer accepts work, so no waiter of this lane
+                    // will ever run: drop them all so their futures break
+                    // instead of hanging
+                    std::deque<std::function<void()>> dropped;
+                    {
+                        std::lock_guard<std::mutex> lock(lane_->mutex);
+                        --lane_->running;
+                        dropped.swap(lane_->waiting);
+                    }
+                }
+            }
+        }
+        
+        SlotRelease(const SlotRelease&) = delete;
+        SlotRelease& operator=(const SlotRelease&) = delete;
+        
+    private:
+        ThreadPool& pool_;
+        const std::shared_ptr<detail::LaneState>& lane_;
+    };
+    
+    ThreadPool* pool_;
+    std::shared_ptr<detail::LaneState> lane_;
+};
+
+inline LimitedExecutor ThreadPool::limited(const std::string& key, size_t max_concurrency) {
+    std::shared_ptr<detail::LaneState> lane;
+    {
+        std::lock_guard<std::mutex> lock(lanes_mutex_);
+        auto& slot = lanes_[key];
+        if (!slot) {
+            slot = std::make_shared<detail::LaneState>();
+        }
+        lane = slot;
+    }
+    
+    // Raising the limit releases waiting tasks straight away
+    std::vector<std::function<void()>> released;
+    {
+        std::lock_guard<std::mutex> lock(lane->mutex);
+        lane->limit = std::max<size_t>(max_concurrency, 1);
+        while (!lane->waiting.empty() && lane->running < lane->limit) {
+            released.push_back(std::move(lane->waiting.front()));
+            lane->waiting.pop_front();
+            ++lane->running;
+        }
+    }
+    for (size_t i = 0; i < released.size(); ++i) {
+        try {
+            submit(std::move(released[i]));
+        } catch (...) {
+            // Give back the slots of the jobs not submitted and requeue them in
+            // order; a lane task still draining on a worker may release them
+            std::lock_guard<std::mutex> lock(lane->mutex);
+            lane->running -= released.size() - i;
+            for (size_t j = released.size(); j > i; --j) {
+                lane->waiting.push_front(std::move(released[j - 1]));
+            }
+            throw;
+        }
+    }
+    return LimitedExecutor(*this, std::move(lane));
+}
+
+/**
+ * @brief One lazily created T per worker of a pool, plus one per outside thread
+ * 
+ * Tasks accumulate into local() without synchronisation; combine() or
+ * for_each() merges the instances once the tasks are done. Worker slots are
+ * padded to a cache line so neighbouring workers do not false-share.
+ * Threads outside the pool (e.g. a caller inside wait_helping) get instances
+ * from a mutex-protected map.
+ * 
+ * local() must not race with combine(), for_each() or clear().
+ */
+template<typename T>
+class WorkerLocal {
+public:
+    /**
+     * @brief Create storage for the workers of a pool
+     * @param init Produces the initial value of each instance
+     */
+    explicit WorkerLocal(const ThreadPool& pool, std::function<T()> init = [] { return T(); })
+        : pool_(&pool)
+        , init_(std::move(init))
+        , slots_(pool.size())
+    {}
+    
+    WorkerLocal(const WorkerLocal&) = delete;
+    WorkerLocal& operator=(const WorkerLocal&) = delete;
+    
+    /**
+     * @brief The calling thread's instance, created on first use
+     */
+    T& local() {
+        if (detail::current_pool == pool_ && detail::current_worker < slots_.size()) {
+            Slot& slot = slots_[detail::current_worker];
+            if (!slot.value) {
+                slot.value.emplace(init_());
+            }
+            return *slot.value;
+        }
+        
+        std::lock_guard<std::mutex> lock(external_mutex_);
+        auto& slot = external_[std::this_thread::get_id()];
+        if (!slot) {
+            slot = std::make_unique<Slot>();
+            slot->value.emplace(init_());
+        }
+        return *slot->value;
+    }
+    
+    /**
+     * @brief Visit every instance created so far
+     */
+    template<typename Func>
+    void for_each(Func&& func) {
+        for (auto& slot : slots_) {
+            if (slot.value) {
+                func(*slot.value);
+            }
+        }
+        std::lock_guard<std::mutex> lock(external_mutex_);
+        for (auto& [id, slot] : external_) {
+            func(*slot->value);
+        }
+    }
+    
+    /**
+     * @brief Fold all instances with op, or return init() if there are none
+     */
+    template<typename BinaryOp>
+    T combine(BinaryOp&& op) {
+        std::optional<T> result;
+        for_each([&](T& value) {
+            if (result) {
+                result.emplace(op(std::move(*result), value));
+            } else {
+                result.emplace(value);
+            }
+        });
+        return result ? std::move(*result) : init_();
+    }
+    
+    /**
+     * @brief Number of instances created so far
+     */
+    size_t instances() {
+        size_t count = 0;
+        for_each([&count](T&) { ++count; });
+        return count;
+    }
+    
+    /**
+     * @brief Destroy all instances; the next local() call re-creates them
+     */
+    void clear() {
+        for (auto& slot : slots_) {
+            slot.value.reset();
+        }
+        std::lock_guard<std::mutex> lock(external_mutex_);
+        external_.clear();
+    }
+
+private:
+    struct alignas(detail::cache_line_size) Slot {
+        std::optional<T> value;
+    };
+    
+    const void* pool_;
+    std::function<T()> init_;
+    std::vector<Slot> slots_;
+    
+    std::mutex external_mutex_;
+    std::map<std::thread::id, std::unique_ptr<Slot>> external_;
 };
 
+namespace detail {
+
+/**
+ * @brief Run body(chunk) for chunk in [0, chunks) on the pool and help until done
+ */
+template<typename Body>
+void run_chunks(ThreadPool& pool, size_t chunks, Body& body) {
+    if (chunks == 1) {
+        body(size_t{0});
+        return;
+    }
+    std::vector<std::future<void>> futures;
+    futures.reserve(chunks);
+    try {
+        for (size_t c = 0; c < chunks; ++c) {
+            futures.push_back(pool.submit([&body, c] { body(c); }));
+        }
+    } catch (...) {
+        // Chunks already submitted reference body; let them finish first
+        for (auto& f : futures) {
+            pool.wait_helping(f);
+        }
+        throw;
+    }
+    for (auto& f : futures) {
+        pool.wait_helping(f);
+    }
+    for (auto& f : futures) {
+        f.get();
+    }
+}
+
+} // namespace detail
+
 /**
  * @brief Parallel for loop utility
  */
@@ -148,6 +148,56 @@ TEST_F(ThreadPoolTest, PriorityTasksExecuteFirst) {
     EXPECT_EQ(execution_order[4], 0);  // Priority 10
 }
 
+TEST_F(ThreadPoolTest, NestedWaitHelpingOnSingleThread) {
+    tp::ThreadPool pool(1);
+    
+    std::function<int(int)> sum_tree = [&pool, &sum_tree](int depth) -> int {
+        if (depth == 0) {
+            return 1;
+        }
+        auto left = pool.submit(sum_tree, depth - 1);
+        auto right = pool.submit(sum_tree, depth - 1);
+        pool.wait_helping(left);
+        pool.wait_helping(right);
+        return 1 + left.get() + right.get();
+    };
+    
+    auto root = pool.submit(sum_tree, 6);
+    EXPECT_EQ(root.get(), 127);
+}
+
+TEST_F(ThreadPoolTest, IdleWorkerStealsChildOfBlockedTask) {
+    tp::ThreadPool pool(2);
+    
+    // The child lands in the parent's own deque; the parent blocks without
+    // helping, so only the other worker stealing it can finish the parent
+    auto parent = pool.submit([&pool] {
+        auto child = pool.submit([] { return 7; });
+        return child.get();
+    });
+    EXPECT_EQ(parent.get(), 7);
+    EXPECT_GE(pool.stats().total_tasks_stolen, 1u);
+}
+
+TEST_F(ThreadPoolTest, RunPendingTaskFromExternalThread) {
+    tp::ThreadPool pool(1);
+    
+    // Occupy the only worker
+    std::promise<void> blocker;
+    auto blocked = pool.submit([&blocker] { blocker.get_future().wait(); });
+    while (pool.active() == 0) {
+        std::this_thread::yield();
+    }
+    
+    auto future = pool.submit([] { return std::this_thread::get_id(); });
+    EXPECT_TRUE(pool.run_pending_task());
+    EXPECT_EQ(future.get(), std::this_thread::get_id());
+    EXPECT_FALSE(pool.run_pending_task());
+    
+    blocker.set_value();
+    blocked.wait();
+}
+
 int main(int argc, char** argv) {
     testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,253 @@
+#include <threadpool/threadpool.hpp>
+#include <threadpool/concurrent_hash_map.hpp>
+#include <threadpool/channel.hpp>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(ConcurrentHashSetTest, InsertIfAbsentReportsFirstInserter) {
+    tp::ThreadPool pool(4);
+    tp::ConcurrentHashSet<int> set;
+    std::atomic<int> first_inserts{0};
+    
+    // Every key is inserted by four different tasks
+    tp::parallel_for(pool, 0, 4000, [&](size_t i) {
+        if (set.insert(static_cast<int>(i % 1000))) {
+            ++first_inserts;
+        }
+    });
+    
+    EXPECT_EQ(first_inserts.load(), 1000);
+    EXPECT_EQ(set.size(), 1000u);
+}
+
+TEST(ConcurrentHashSetTest, ContainsEraseAndForEach) {
+    tp::ConcurrentHashSet<std::string> set(4);
+    EXPECT_EQ(set.shard_count(), 4u);
+    EXPECT_TRUE(set.empty());
+    
+    EXPECT_TRUE(set.insert("a"));
+    EXPECT_TRUE(set.insert("b"));
+    EXPECT_FALSE(set.insert("a"));
+    EXPECT_TRUE(set.contains("b"));
+    EXPECT_TRUE(set.erase("b"));
+    EXPECT_FALSE(set.contains("b"));
+    EXPECT_FALSE(set.erase("b"));
+    
+    size_t visited = 0;
+    set.for_each([&visited](const std::string& key) {
+        EXPECT_EQ(key, "a");
+        ++visited;
+    });
+    EXPECT_EQ(visited, 1u);
+    
+    set.clear();
+    EXPECT_TRUE(set.empty());
+}
+
+TEST(ConcurrentHashMapTest, UpsertCountsConcurrently) {
+    tp::ThreadPool pool(4);
+    tp::ConcurrentHashMap<int, int> counts;
+    
+    tp::parallel_for(pool, 0, 1000, [&counts](size_t i) {
+        counts.upsert(static_cast<int>(i % 10), [](int& c) { ++c; });
+    });
+    
+    EXPECT_EQ(counts.size(), 10u);
+    int total = 0;
+    counts.for_each([&total](int, int c) {
+        EXPECT_EQ(c, 100);
+        total += c;
+    });
+    EXPECT_EQ(total, 1000);
+}
+
+TEST(ConcurrentHashMapTest, InsertFindUpdate) {
+    tp::ConcurrentHashMap<std::string, int> map;
+    
+    EXPECT_TRUE(map.insert("x", 1));
+    EXPECT_FALSE(map.insert("x", 2));
+    EXPECT_EQ(map.find("x"), 1);
+    EXPECT_FALSE(map.find("y").has_value());
+    
+    EXPECT_FALSE(map.insert_or_assign("x", 3));
+    EXPECT_EQ(map.find("x"), 3);
+    
+    EXPECT_TRUE(map.update("x", [](int& v) { v *= 2; }));
+    EXPECT_FALSE(map.update("y", [](int& v) { v = 0; }));
+    EXPECT_EQ(map.find("x"), 6);
+    
+    EXPECT_TRUE(map.erase("x"));
+    EXPECT_FALSE(map.contains("x"));
+}
+
+TEST(ChannelTest, BoundedTrySendAndReceive) {
+    tp::ThreadPool pool(2);
+    tp::Channel<int> channel(pool, 4);
+    EXPECT_TRUE(channel.is_bounded());
+    EXPECT_EQ(channel.capacity(), 4u);
+    
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(channel.try_send(i));
+    }
+    EXPECT_FALSE(channel.try_send(4));
+    EXPECT_EQ(channel.size(), 4u);
+    
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(channel.try_receive(), i);
+    }
+    EXPECT_FALSE(channel.try_receive().has_value());
+}
+
+TEST(ChannelTest, AsyncSendParksUntilSpace) {
+    tp::ThreadPool pool(2);
+    tp::Channel<std::unique_ptr<int>> channel(pool, 1);
+    
+    EXPECT_TRUE(channel.async_send(std::make_unique<int>(1)).get());
+    auto parked = channel.async_send(std::make_unique<int>(2));
+    EXPECT_EQ(parked.wait_for(std::chrono::milliseconds(0)), std::future_status::timeout);
+    EXPECT_EQ(channel.waiting_senders(), 1u);
+    
+    // Receiving frees the slot and moves the parked value in
+    EXPECT_EQ(**channel.try_receive(), 1);
+    EXPECT_TRUE(parked.get());
+    EXPECT_EQ(channel.waiting_senders(), 0u);
+    EXPECT_EQ(**channel.try_receive(), 2);
+}
+
+TEST(ChannelTest, AsyncReceiveParksUntilValue) {
+    tp::ThreadPool pool(2);
+    tp::Channel<int> channel(pool);
+    
+    auto value = channel.async_receive();
+    auto doubled = channel.async_receive([](std::optional<int> v) { return *v * 2; });
+    EXPECT_EQ(channel.waiting_receivers(), 2u);
+    
+    EXPECT_TRUE(channel.try_send(7));
+    EXPECT_TRUE(channel.try_send(8));
+    EXPECT_EQ(value.get(), 7);
+    EXPECT_EQ(doubled.get(), 16);
+    EXPECT_EQ(channel.waiting_receivers(), 0u);
+}
+
+TEST(ChannelTest, CloseCompletesParkedRequests) {
+    tp::ThreadPool pool(2);
+    tp::Channel<int> full(pool, 1);
+    EXPECT_TRUE(full.try_send(1));
+    auto parked_send = full.async_send(2);
+    full.close();
+    EXPECT_FALSE(parked_send.get());
+    EXPECT_FALSE(full.try_send(3));
+    EXPECT_EQ(full.async_receive().get(), 1);     // Buffered values still drain
+    EXPECT_EQ(full.async_receive().get(), std::nullopt);
+    
+    tp::Channel<int> empty(pool);
+    auto parked_receive = empty.async_receive();
+    auto callback = empty.async_receive([](std::optional<int> v) { return v.has_value(); });
+    empty.close();
+    EXPECT_EQ(parked_receive.get(), std::nullopt);
+    EXPECT_FALSE(callback.get());
+    EXPECT_FALSE(empty.async_send(4).get());
+}
+
+TEST(ChannelTest, CloseRacingSendNeverLosesValue) {
+    tp::ThreadPool pool(2);
+    for (int round = 0; round < 500; ++round) {
+        tp::Channel<int> channel(pool, 4);
+        auto parked = channel.async_receive();
+        
+        std::atomic<bool> go{false};
+        bool sent = false;
+        std::thread sender([&] {
+            while (!go.load()) {}
+            sent = channel.try_send(round);
+        });
+        std::thread closer([&] {
+            while (!go.load()) {}
+            channel.close();
+        });
+        go = true;
+        sender.join();
+        closer.join();
+        
+        // A send reported as successful must reach the parked receiver
+        auto value = parked.get();
+        ASSERT_EQ(value.has_value(), sent) << "round " << round;
+        if (sent) {
+            EXPECT_EQ(*value, round);
+        }
+    }
+}
+
+TEST(ChannelTest, UnboundedOverflowKeepsOrder) {
+    tp::ThreadPool pool(2);
+    tp::Channel<int> channel(pool);
+    const int count = static_cast<int>(tp::Channel<int>::unbounded_ring_capacity) * 3;
+    
+    for (int i = 0; i < count; ++i) {
+        ASSERT_TRUE(channel.try_send(i));
+    }
+    EXPECT_EQ(channel.size(), static_cast<size_t>(count));
+    for (int i = 0; i < count; ++i) {
+        ASSERT_EQ(channel.try_receive(), i);
+    }
+    EXPECT_EQ(channel.size(), 0u);
+}
+
+TEST(ChannelTest, PipelineWithoutBlockedWorkers) {
+    // Two workers, four producers and four consumers: a stage that blocked
+    // a worker while waiting would deadlock here
+    tp::ThreadPool pool(2);
+    tp::Channel<int> channel(pool, 8);
+    const int producers = 4;
+    const int consumers = 4;
+    const int per_producer = 2000;
+    
+    std::atomic<long long> sum{0};
+    std::atomic<int> received{0};
+    std::atomic<int> finished{0};
+    std::promise<void> all_done;
+    
+    // Each consumer re-arms itself from its own continuation
+    std::function<void(std::optional<int>)> consume = [&](std::optional<int> value) {
+        if (!value) {
+            if (++finished == consumers) {
+                all_done.set_value();
+            }
+            return;
+        }
+        sum += *value;
+        ++received;
+        channel.async_receive(consume);
+    };
+    for (int c = 0; c < consumers; ++c) {
+        channel.async_receive(consume);
+    }
+    
+    std::vector<std::future<void>> sent;
+    for (int p = 0; p < producers; ++p) {
+        sent.push_back(pool.submit([&, p] {
+            for (int i = 1; i <= per_producer; ++i) {
+                auto accepted = channel.async_send(p * per_producer + i);
+                pool.wait_helping(accepted);
+                ASSERT_TRUE(accepted.get());
+            }
+        }));
+    }
+    for (auto& f : sent) {
+        pool.wait_helping(f);
+        f.get();
+    }
+    channel.close();
+    all_done.get_future().get();
+    
+    const long long n = producers * per_producer;
+    EXPECT_EQ(received.load(), n);
+    EXPECT_EQ(sum.load(), n * (n + 1) / 2);
+}
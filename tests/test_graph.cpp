@@ -0,0 +1,127 @@
+#include <threadpool/threadpool.hpp>
+#include <threadpool/parallel_bfs.hpp>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <queue>
+#include <random>
+
+namespace {
+
+/**
+ * @brief Random symmetric graph with a given average degree
+ */
+tp::CsrGraph random_graph(uint32_t vertices, size_t avg_degree, uint32_t seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<uint32_t> pick(0, vertices - 1);
+    std::vector<std::vector<uint32_t>> adjacency(vertices);
+    for (size_t e = 0; e < vertices * avg_degree / 2; ++e) {
+        uint32_t a = pick(gen), b = pick(gen);
+        adjacency[a].push_back(b);
+        adjacency[b].push_back(a);
+    }
+    
+    tp::CsrGraph graph;
+    graph.offsets.push_back(0);
+    for (const auto& list : adjacency) {
+        graph.targets.insert(graph.targets.end(), list.begin(), list.end());
+        graph.offsets.push_back(graph.targets.size());
+    }
+    return graph;
+}
+
+std::vector<int32_t> serial_bfs(const tp::CsrGraph& graph, uint32_t root) {
+    std::vector<int32_t> depth(graph.vertices(), -1);
+    std::queue<uint32_t> queue;
+    depth[root] = 0;
+    queue.push(root);
+    while (!queue.empty()) {
+        uint32_t v = queue.front();
+        queue.pop();
+        for (uint64_t e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e) {
+            uint32_t u = graph.targets[e];
+            if (depth[u] == -1) {
+                depth[u] = depth[v] + 1;
+                queue.push(u);
+            }
+        }
+    }
+    return depth;
+}
+
+} // namespace
+
+TEST(GraphTest, ImplicitBinaryTree) {
+    tp::ThreadPool pool(4);
+    tp::BfsOptions options;
+    options.chunk_size = 8;
+    
+    // Children of i are 2i+1 and 2i+2, below 1023: a complete tree of 10 levels
+    std::atomic<size_t> expanded{0};
+    auto stats = tp::parallel_bfs(pool, std::vector<int>{0}, [&](int node, size_t, auto& emit) {
+        ++expanded;
+        for (int child : {2 * node + 1, 2 * node + 2}) {
+            if (child < 1023) {
+                emit(child);
+            }
+        }
+    }, options);
+    
+    EXPECT_EQ(stats.visited, 1023u);
+    EXPECT_EQ(expanded.load(), 1023u);
+    EXPECT_EQ(stats.levels, 10u);
+    EXPECT_EQ(stats.frontier_sizes.back(), 512u);
+}
+
+TEST(GraphTest, DeduplicatesAndRespectsMaxDepth) {
+    tp::ThreadPool pool(2);
+    tp::BfsOptions options;
+    options.max_depth = 3;
+    
+    // Integer line where every node links both ways; duplicate roots
+    std::atomic<size_t> max_seen{0};
+    auto stats = tp::parallel_bfs(pool, std::vector<int>{50, 50}, [&](int node, size_t depth, auto& emit) {
+        size_t seen = max_seen.load();
+        while (depth > seen && !max_seen.compare_exchange_weak(seen, depth)) {}
+        emit(node - 1);
+        emit(node + 1);
+    }, options);
+    
+    EXPECT_EQ(stats.visited, 7u);      // 47..53
+    EXPECT_EQ(stats.levels, 3u);
+    EXPECT_EQ(max_seen.load(), 2u);    // depth-3 nodes are not expanded
+    EXPECT_EQ(stats.edges, 10u);       // 1 + 2 + 2 nodes, two emits each
+}
+
+TEST(GraphTest, CsrMatchesSerialBfs) {
+    tp::ThreadPool pool(4);
+    tp::CsrGraph graph = random_graph(20000, 8, 5);
+    auto expected = serial_bfs(graph, 0);
+    
+    for (bool direction_optimizing : {false, true}) {
+        tp::BfsOptions options;
+        options.chunk_size = 64;
+        options.direction_optimizing = direction_optimizing;
+        auto result = tp::parallel_bfs(pool, graph, 0, options);
+        
+        EXPECT_EQ(result.depth, expected);
+        size_t reached = static_cast<size_t>(std::count_if(expected.begin(), expected.end(), 
+                                                           [](int32_t d) { return d >= 0; }));
+        EXPECT_EQ(result.stats.visited, reached);
+        if (direction_optimizing) {
+            EXPECT_GT(result.stats.bottom_up_levels, 0u);
+        } else {
+            EXPECT_EQ(result.stats.bottom_up_levels, 0u);
+        }
+    }
+}
+
+TEST(GraphTest, RunsInsideATask) {
+    tp::ThreadPool pool(1);
+    tp::CsrGraph graph = random_graph(2000, 4, 9);
+    auto expected = serial_bfs(graph, 3);
+    
+    // A single worker must help with the level tasks instead of blocking
+    auto depth = pool.submit([&] { return tp::parallel_bfs(pool, graph, 3).depth; }).get();
+    EXPECT_EQ(depth, expected);
+}
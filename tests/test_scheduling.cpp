@@ -0,0 +1,334 @@
+#include <threadpool/threadpool.hpp>
+#include <threadpool/rate_limiter.hpp>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+using SteadyClock = std::chrono::steady_clock;
+
+TEST(SchedulingTest, SubmitAfterWaitsForDelay) {
+    tp::ThreadPool pool(2);
+    auto start = SteadyClock::now();
+    
+    auto future = pool.submit_after(30ms, [start] { return SteadyClock::now() - start; });
+    
+    EXPECT_GE(future.get(), 30ms);
+}
+
+TEST(SchedulingTest, DelayedTaskDoesNotOccupyWorker) {
+    tp::ThreadPool pool(1);
+    auto delayed = pool.submit_after(200ms, [] { return 1; });
+    
+    // The only worker must still be free for immediate work
+    auto immediate = pool.submit([] { return 2; });
+    EXPECT_EQ(immediate.wait_for(100ms), std::future_status::ready);
+    EXPECT_EQ(delayed.wait_for(0ms), std::future_status::timeout);
+    EXPECT_EQ(delayed.get(), 1);
+}
+
+TEST(SchedulingTest, DelayedTasksRunInDueOrder) {
+    tp::ThreadPool pool(1);
+    std::mutex mutex;
+    std::vector<int> order;
+    auto record = [&](int value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        order.push_back(value);
+    };
+    
+    auto now = SteadyClock::now();
+    pool.submit_at(now + 40ms, record, 3);
+    pool.submit_at(now + 10ms, record, 1);
+    pool.submit_at(now + 20ms, record, 2);
+    pool.wait();
+    
+    EXPECT_EQ(order, (std::vector<int>{1, 2, 3}));
+}
+
+TEST(SchedulingTest, GracefulShutdownRunsDelayedTasks) {
+    std::atomic<bool> ran{false};
+    {
+        tp::ThreadPool pool(2);
+        pool.submit_after(20ms, [&ran] { ran = true; });
+    }
+    EXPECT_TRUE(ran);
+}
+
+TEST(SchedulingTest, ShutdownNowCancelsDelayedTasks) {
+    tp::ThreadPool pool(1);
+    auto future = pool.submit_after(1h, [] {});
+    EXPECT_EQ(pool.pending(), 1u);
+    
+    pool.shutdown_now();
+    EXPECT_EQ(pool.pending(), 0u);
+    EXPECT_THROW(future.get(), std::future_error);
+}
+
+TEST(SchedulingTest, ShutdownNowRejectsSubmitsFromWorkers) {
+    std::promise<void> started;
+    std::promise<void> gate;
+    std::promise<bool> rejected;
+    {
+        tp::ThreadPool pool(1);
+        
+        // A task that keeps re-arming itself must not keep the pool alive
+        std::function<void()> tick = [&pool, &tick] {
+            try {
+                pool.submit_after(1ms, tick);
+            } catch (const std::runtime_error&) {
+            }
+        };
+        pool.submit(tick);
+        
+        pool.submit([&] {
+            started.set_value();
+            gate.get_future().wait();
+            try {
+                pool.submit([] {});
+                rejected.set_value(false);
+            } catch (const std::runtime_error&) {
+                rejected.set_value(true);
+            }
+        });
+        started.get_future().wait();
+        pool.shutdown_now();
+        gate.set_value();
+    }
+    EXPECT_TRUE(rejected.get_future().get());
+}
+
+TEST(SchedulingTest, RateLimiterSpacesTasks) {
+    tp::ThreadPool pool(2);
+    tp::RateLimitedExecutor limiter(pool, 100.0, 5.0);   // 10 ms per token after a burst of 5
+    
+    auto start = SteadyClock::now();
+    std::vector<std::future<SteadyClock::time_point>> futures;
+    for (int i = 0; i < 15; ++i) {
+        futures.push_back(limiter.submit([] { return SteadyClock::now(); }));
+    }
+    EXPECT_GT(limiter.queued(), 0u);
+    
+    std::vector<SteadyClock::time_point> starts;
+    for (auto& f : futures) {
+        starts.push_back(f.get());
+    }
+    
+    // 10 tasks beyond the burst need ~100 ms of tokens
+    EXPECT_GE(starts.back() - start, 80ms);
+    EXPECT_LT(starts[4] - start, 80ms);
+    EXPECT_EQ(limiter.queued(), 0u);
+}
+
+TEST(SchedulingTest, RateLimiterRejectsNonPositiveRate) {
+    tp::ThreadPool pool(1);
+    EXPECT_THROW(tp::RateLimitedExecutor(pool, 0.0), std::invalid_argument);
+    EXPECT_THROW(tp::RateLimitedExecutor(pool, -5.0), std::invalid_argument);
+    EXPECT_THROW(tp::KeyedRateLimitedExecutor<int>(pool, 0.0), std::invalid_argument);
+    EXPECT_THROW(tp::RateLimitedExecutor(pool, 10.0, 0.5), std::invalid_argument);
+    EXPECT_THROW(tp::KeyedRateLimitedExecutor<int>(pool, 10.0, 0.0), std::invalid_argument);
+}
+
+TEST(SchedulingTest, ShutdownNowBreaksRateLimitedTasks) {
+    tp::ThreadPool pool(1);
+    tp::RateLimitedExecutor limiter(pool, 0.5, 1.0);
+    
+    limiter.submit([] {}).get();
+    auto waiting = limiter.submit([] {});
+    EXPECT_EQ(limiter.queued(), 1u);
+    
+    // Discarding the scheduled drain must not leave the task parked forever
+    pool.shutdown_now();
+    EXPECT_EQ(waiting.wait_for(0s), std::future_status::ready);
+    EXPECT_THROW(waiting.get(), std::future_error);
+    EXPECT_EQ(limiter.queued(), 0u);
+}
+
+TEST(SchedulingTest, RateLimiterLeavesWorkersFree) {
+    tp::ThreadPool pool(1);
+    tp::RateLimitedExecutor limiter(pool, 10.0, 1.0);
+    
+    std::vector<std::future<void>> limited;
+    for (int i = 0; i < 3; ++i) {
+        limited.push_back(limiter.submit([] {}));
+    }
+    
+    // Backlogged limiter must not hold the single worker
+    EXPECT_EQ(pool.submit([] {}).wait_for(50ms), std::future_status::ready);
+    for (auto& f : limited) {
+        f.get();
+    }
+}
+
+TEST(SchedulingTest, KeyedRateLimiterIsolatesKeys) {
+    tp::ThreadPool pool(2);
+    tp::KeyedRateLimitedExecutor<std::string> limiter(pool, 5.0, 1.0);
+    
+    // Saturate one key; another key must not wait behind it
+    std::vector<std::future<void>> slow;
+    for (int i = 0; i < 4; ++i) {
+        slow.push_back(limiter.submit("a.example", [] {}));
+    }
+    auto other = limiter.submit("b.example", [] {});
+    
+    EXPECT_EQ(other.wait_for(100ms), std::future_status::ready);
+    EXPECT_EQ(limiter.keys(), 2u);
+    EXPECT_GT(limiter.queued(), 0u);
+    for (auto& f : slow) {
+        f.get();
+    }
+}
+
+TEST(SchedulingTest, LimitedLaneCapsConcurrency) {
+    tp::ThreadPool pool(4);
+    std::atomic<int> running{0};
+    std::atomic<int> peak{0};
+    
+    std::vector<std::future<void>> futures;
+    for (int i = 0; i < 20; ++i) {
+        futures.push_back(pool.limited("db", 2).submit([&] {
+            int now = ++running;
+            int seen = peak.load();
+            while (now > seen && !peak.compare_exchange_weak(seen, now)) {}
+            std::this_thread::sleep_for(2ms);
+            --running;
+        }));
+    }
+    for (auto& f : futures) {
+        f.get();
+    }
+    
+    EXPECT_LE(peak.load(), 2);
+    EXPECT_GE(peak.load(), 1);
+    EXPECT_EQ(pool.limited("db", 2).running(), 0u);
+}
+
+TEST(SchedulingTest, LimitedLaneLeavesWorkersFree) {
+    std::promise<void> gate;
+    std::shared_future<void> open = gate.get_future().share();
+    tp::ThreadPool pool(2);
+    auto lane = pool.limited("slow", 1);
+    
+    std::vector<std::future<void>> slow;
+    for (int i = 0; i < 5; ++i) {
+        slow.push_back(lane.submit([open] { open.wait(); }));
+    }
+    EXPECT_EQ(lane.queued(), 4u);
+    
+    // Queued lane tasks are outside the pool; the second worker stays free
+    // even while the lane is blocked
+    EXPECT_EQ(pool.submit([] {}).wait_for(1s), std::future_status::ready);
+    gate.set_value();
+    for (auto& f : slow) {
+        f.get();
+    }
+    EXPECT_EQ(lane.queued(), 0u);
+}
+
+TEST(SchedulingTest, RaisingLaneLimitReleasesWaiters) {
+    tp::ThreadPool pool(4);
+    std::promise<void> gate;
+    std::shared_future<void> opened = gate.get_future().share();
+    
+    auto lane = pool.limited("io", 1);
+    std::vector<std::future<void>> futures;
+    for (int i = 0; i < 3; ++i) {
+        futures.push_back(lane.submit([opened] { opened.wait(); }));
+    }
+    EXPECT_EQ(lane.queued(), 2u);
+    
+    pool.limited("io", 3);
+    EXPECT_EQ(lane.queued(), 0u);
+    EXPECT_EQ(lane.max_concurrency(), 3u);
+    
+    gate.set_value();
+    for (auto& f : futures) {
+        f.get();
+    }
+}
+
+TEST(SchedulingTest, LaneSubmitToStoppedPoolReturnsSlot) {
+    tp::ThreadPool pool(1);
+    auto lane = pool.limited("stopped", 1);
+    pool.shutdown();
+    
+    EXPECT_THROW(lane.submit([] {}), std::runtime_error);
+    EXPECT_EQ(lane.running(), 0u);
+}
+
+TEST(SchedulingTest, RaisingLaneLimitAfterShutdownRequeuesWaiters) {
+    std::promise<void> started;
+    std::promise<void> gate;
+    tp::ThreadPool pool(1);
+    auto lane = pool.limited("raised", 1);
+    
+    auto first = lane.submit([&] {
+        started.set_value();
+        gate.get_future().wait();
+    });
+    std::vector<std::future<void>> queued;
+    for (int i = 0; i < 2; ++i) {
+        queued.push_back(lane.submit([] {}));
+    }
+    started.get_future().wait();
+    pool.shutdown();
+    
+    EXPECT_THROW(pool.limited("raised", 3), std::runtime_error);
+    EXPECT_EQ(lane.running(), 1u);
+    EXPECT_EQ(lane.queued(), 2u);
+    
+    // The running task still hands its slot on while the pool drains
+    gate.set_value();
+    first.get();
+    for (auto& f : queued) {
+        f.get();
+    }
+    EXPECT_EQ(lane.running(), 0u);
+}
+
+TEST(SchedulingTest, ShutdownNowBreaksQueuedLaneTasks) {
+    std::promise<void> started;
+    std::promise<void> gate;
+    tp::ThreadPool pool(1);
+    auto lane = pool.limited("cancelled", 1);
+    
+    auto first = lane.submit([&] {
+        started.set_value();
+        gate.get_future().wait();
+    });
+    std::vector<std::future<void>> queued;
+    for (int i = 0; i < 3; ++i) {
+        queued.push_back(lane.submit([] {}));
+    }
+    started.get_future().wait();
+    
+    // The running task cannot hand its slot on; every waiter must be dropped
+    pool.shutdown_now();
+    gate.set_value();
+    first.get();
+    for (auto& f : queued) {
+        EXPECT_THROW(f.get(), std::future_error);
+    }
+    EXPECT_EQ(lane.queued(), 0u);
+    EXPECT_EQ(lane.running(), 0u);
+}
+
+TEST(SchedulingTest, GracefulShutdownRunsQueuedLaneTasks) {
+    std::atomic<int> done{0};
+    {
+        tp::ThreadPool pool(2);
+        for (int i = 0; i < 6; ++i) {
+            pool.limited("one", 1).submit([&done] {
+                std::this_thread::sleep_for(1ms);
+                ++done;
+            });
+        }
+    }
+    EXPECT_EQ(done.load(), 6);
+}
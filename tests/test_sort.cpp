@@ -0,0 +1,274 @@
+#include <threadpool/threadpool.hpp>
+#include <threadpool/parallel_radix_sort.hpp>
+#include <threadpool/external_sort.hpp>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+template<typename T>
+std::vector<T> random_values(size_t count, uint32_t seed) {
+    std::mt19937_64 gen(seed);
+    std::uniform_int_distribution<T> dist(std::numeric_limits<T>::min(), std::numeric_limits<T>::max());
+    std::vector<T> values(count);
+    for (auto& v : values) {
+        v = dist(gen);
+    }
+    return values;
+}
+
+struct Record {
+    uint32_t key;
+    uint32_t order;
+};
+
+template<typename T>
+void write_file(const std::filesystem::path& path, const std::vector<T>& records) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(records.data()),
+              static_cast<std::streamsize>(records.size() * sizeof(T)));
+}
+
+template<typename T>
+std::vector<T> read_file(const std::filesystem::path& path) {
+    std::vector<T> records(std::filesystem::file_size(path) / sizeof(T));
+    std::ifstream in(path, std::ios::binary);
+    in.read(reinterpret_cast<char*>(records.data()),
+            static_cast<std::streamsize>(records.size() * sizeof(T)));
+    return records;
+}
+
+/**
+ * @brief Fresh directory under the system temp dir, removed afterwards
+ */
+class ExternalSortTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        const auto* info = ::testing::UnitTest::GetInstance()->current_test_info();
+        dir_ = std::filesystem::temp_directory_path() /
+               (std::string("tp-test-") + info->name());
+        std::filesystem::remove_all(dir_);
+        std::filesystem::create_directories(dir_ / "spill");
+    }
+    
+    void TearDown() override {
+        std::filesystem::remove_all(dir_);
+    }
+    
+    std::filesystem::path dir_;
+};
+
+} // namespace
+
+TEST(RadixSortTest, SortsUnsigned32) {
+    tp::ThreadPool pool(4);
+    auto values = random_values<uint32_t>(200000, 1);
+    auto expected = values;
+    std::sort(expected.begin(), expected.end());
+    
+    tp::parallel_radix_sort(pool, values.begin(), values.end());
+    EXPECT_EQ(values, expected);
+}
+
+TEST(RadixSortTest, SortsSigned64) {
+    tp::ThreadPool pool(4);
+    auto values = random_values<int64_t>(150000, 2);
+    values.push_back(std::numeric_limits<int64_t>::min());
+    values.push_back(std::numeric_limits<int64_t>::max());
+    values.push_back(0);
+    values.push_back(-1);
+    auto expected = values;
+    std::sort(expected.begin(), expected.end());
+    
+    tp::parallel_radix_sort(pool, values.data(), values.data() + values.size());
+    EXPECT_EQ(values, expected);
+}
+
+TEST(RadixSortTest, SmallAndDegenerateInputs) {
+    tp::ThreadPool pool(2);
+    
+    std::vector<int> empty;
+    tp::parallel_radix_sort(pool, empty.begin(), empty.end());
+    EXPECT_TRUE(empty.empty());
+    
+    std::vector<int> small = {5, -3, 9, 0, -3, 2};
+    tp::parallel_radix_sort(pool, small.begin(), small.end());
+    EXPECT_EQ(small, (std::vector<int>{-3, -3, 0, 2, 5, 9}));
+    
+    // Every digit identical: all passes are skipped
+    std::vector<uint64_t> same(50000, 0x0123456789abcdefULL);
+    tp::parallel_radix_sort(pool, same.begin(), same.end());
+    EXPECT_TRUE(std::all_of(same.begin(), same.end(),
+                            [](uint64_t v) { return v == 0x0123456789abcdefULL; }));
+    
+    // Only the low byte varies: one pass, result lands in the scratch buffer
+    std::vector<uint32_t> low(50000);
+    for (size_t i = 0; i < low.size(); ++i) {
+        low[i] = static_cast<uint32_t>((low.size() - i) & 0xff);
+    }
+    tp::parallel_radix_sort(pool, low.begin(), low.end());
+    EXPECT_TRUE(std::is_sorted(low.begin(), low.end()));
+}
+
+TEST(RadixSortTest, StableByKey) {
+    tp::ThreadPool pool(4);
+    std::mt19937 gen(3);
+    std::uniform_int_distribution<uint32_t> dist(0, 999);
+    std::vector<Record> records(100000);
+    for (uint32_t i = 0; i < records.size(); ++i) {
+        records[i] = {dist(gen), i};
+    }
+    
+    tp::parallel_radix_sort(pool, records.begin(), records.end(),
+                            [](const Record& r) { return r.key; });
+    
+    for (size_t i = 1; i < records.size(); ++i) {
+        ASSERT_LE(records[i - 1].key, records[i].key);
+        if (records[i - 1].key == records[i].key) {
+            ASSERT_LT(records[i - 1].order, records[i].order);
+        }
+    }
+}
+
+TEST(RadixSortTest, NonTrivialElements) {
+    tp::ThreadPool pool(4);
+    std::vector<std::pair<uint16_t, std::string>> items;
+    for (int i = 0; i < 20000; ++i) {
+        uint16_t key = static_cast<uint16_t>((i * 7919) % 5000);
+        items.emplace_back(key, std::to_string(i));
+    }
+    auto expected = items;
+    std::stable_sort(expected.begin(), expected.end(),
+                     [](const auto& a, const auto& b) { return a.first < b.first; });
+    
+    tp::RadixSortOptions options;
+    options.chunk_size = 1000;
+    tp::parallel_radix_sort(pool, items.begin(), items.end(),
+                            [](const auto& item) { return item.first; }, options);
+    EXPECT_EQ(items, expected);
+}
+
+TEST(RadixSortTest, RunsInsideTask) {
+    tp::ThreadPool pool(2);
+    auto values = random_values<uint64_t>(100000, 4);
+    auto expected = values;
+    std::sort(expected.begin(), expected.end());
+    
+    tp::RadixSortOptions options;
+    options.chunk_size = 4096;
+    auto f = pool.submit([&] {
+        tp::parallel_radix_sort(pool, values.begin(), values.end(), options);
+    });
+    f.get();
+    EXPECT_EQ(values, expected);
+}
+
+TEST_F(ExternalSortTest, MultiPassWithSmallBudget) {
+    tp::ThreadPool pool(4);
+    auto values = random_values<uint64_t>(100000, 5);
+    write_file(dir_ / "in.bin", values);
+    
+    tp::ExternalSortOptions options;
+    options.memory_budget = 64 * 1024;
+    options.min_block_bytes = 4096;
+    options.temp_directory = dir_ / "spill";
+    auto stats = tp::external_sort<uint64_t>(pool, dir_ / "in.bin", dir_ / "out.bin", options);
+    
+    std::sort(values.begin(), values.end());
+    EXPECT_EQ(read_file<uint64_t>(dir_ / "out.bin"), values);
+    EXPECT_EQ(stats.records, values.size());
+    EXPECT_GT(stats.runs, 2u);
+    EXPECT_GT(stats.merge_passes, 1u);
+    EXPECT_TRUE(std::filesystem::is_empty(dir_ / "spill"));
+}
+
+TEST_F(ExternalSortTest, PartitionedFinalMergeWithComparator) {
+    tp::ThreadPool pool(4);
+    std::mt19937 gen(6);
+    std::uniform_int_distribution<uint32_t> dist(0, 5000);
+    std::vector<Record> records(300000);
+    for (uint32_t i = 0; i < records.size(); ++i) {
+        records[i] = {dist(gen), i};
+    }
+    write_file(dir_ / "in.bin", records);
+    
+    tp::ExternalSortOptions options;
+    options.memory_budget = 1 << 20;
+    options.min_block_bytes = 4096;
+    options.temp_directory = dir_ / "spill";
+    auto by_key = [](const Record& a, const Record& b) { return a.key < b.key; };
+    auto stats = tp::external_sort<Record>(pool, dir_ / "in.bin", dir_ / "out.bin",
+                                           options, by_key);
+    EXPECT_GT(stats.runs, 1u);
+    EXPECT_GT(stats.partitions, 1u);
+    
+    auto sorted = read_file<Record>(dir_ / "out.bin");
+    ASSERT_EQ(sorted.size(), records.size());
+    EXPECT_TRUE(std::is_sorted(sorted.begin(), sorted.end(), by_key));
+    
+    // Every record appears exactly once
+    std::vector<bool> seen(records.size(), false);
+    for (const auto& r : sorted) {
+        ASSERT_FALSE(seen[r.order]);
+        seen[r.order] = true;
+    }
+}
+
+TEST_F(ExternalSortTest, EmptyInputAndRunsInsideTask) {
+    tp::ThreadPool pool(2);
+    write_file(dir_ / "empty.bin", std::vector<uint32_t>{});
+    auto stats = tp::external_sort<uint32_t>(pool, dir_ / "empty.bin", dir_ / "empty.out", 1 << 20);
+    EXPECT_EQ(stats.records, 0u);
+    EXPECT_EQ(std::filesystem::file_size(dir_ / "empty.out"), 0u);
+    
+    auto values = random_values<uint32_t>(50000, 7);
+    write_file(dir_ / "in.bin", values);
+    auto f = pool.submit([&] {
+        return tp::external_sort<uint32_t>(pool, dir_ / "in.bin", dir_ / "out.bin", 32 * 1024);
+    });
+    f.get();
+    std::sort(values.begin(), values.end());
+    EXPECT_EQ(read_file<uint32_t>(dir_ / "out.bin"), values);
+}
+
+TEST_F(ExternalSortTest, SpillDirectoriesAreUniqueUnderSeededPools) {
+    tp::PoolConfig config;
+    config.num_threads = 1;
+    config.rng_seed = 42;
+    tp::ThreadPool first(config);
+    tp::ThreadPool second(config);
+    
+    // Same seed and task id: the same per-task random stream in both pools
+    auto spill_in = [this](tp::ThreadPool& pool) {
+        return pool.submit([this] {
+            return std::make_unique<tp::detail::SpillDirectory>(dir_ / "spill");
+        }).get();
+    };
+    auto a = spill_in(first);
+    auto b = spill_in(second);
+    EXPECT_NE(a->path, b->path);
+    EXPECT_TRUE(std::filesystem::is_directory(a->path));
+    EXPECT_TRUE(std::filesystem::is_directory(b->path));
+    
+    auto removed = a->path;
+    a.reset();
+    EXPECT_FALSE(std::filesystem::exists(removed));
+    EXPECT_TRUE(std::filesystem::is_directory(b->path));
+}
+
+TEST_F(ExternalSortTest, RejectsPartialRecords) {
+    tp::ThreadPool pool(2);
+    write_file(dir_ / "in.bin", std::vector<char>(10, 'x'));
+    EXPECT_THROW(tp::external_sort<uint64_t>(pool, dir_ / "in.bin", dir_ / "out.bin", 1 << 20),
+                 std::runtime_error);
+    EXPECT_THROW(tp::external_sort<uint64_t>(pool, dir_ / "missing.bin", dir_ / "out.bin", 1 << 20),
+                 std::runtime_error);
+}
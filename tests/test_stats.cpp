@@ -0,0 +1,150 @@
+#include <threadpool/threadpool.hpp>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <future>
+#include <thread>
+
+class StatsTest : public ::testing::Test {
+protected:
+    static void spin_for(std::chrono::milliseconds duration) {
+        auto end = std::chrono::steady_clock::now() + duration;
+        volatile size_t sink = 0;
+        while (std::chrono::steady_clock::now() < end) {
+            sink = sink + 1;
+        }
+    }
+};
+
+TEST_F(StatsTest, CountersVisibleOnceFutureReady) {
+    tp::ThreadPool pool(2);
+    
+    for (int i = 0; i < 50; ++i) {
+        pool.submit([] {}).wait();
+        EXPECT_EQ(pool.stats().total_tasks_completed, static_cast<size_t>(i + 1));
+    }
+    EXPECT_EQ(pool.stats().total_tasks_submitted, 50u);
+}
+
+TEST_F(StatsTest, CpuSamplingDisabledByDefault) {
+    tp::ThreadPool pool(2);
+    
+    pool.submit_tagged("io", [] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }).wait();
+    
+    auto stats = pool.stats();
+    EXPECT_TRUE(stats.tags.empty());
+    EXPECT_EQ(stats.total_cpu_time.count(), 0);
+    EXPECT_GT(stats.total_execution_time.count(), 0);
+}
+
+#if defined(THREADPOOL_HAS_THREAD_CPUTIME)
+TEST_F(StatsTest, FlagsBlockingTags) {
+    tp::PoolConfig config;
+    config.num_threads = 1;
+    config.sample_cpu_time = true;
+    tp::ThreadPool pool(config);
+    
+    for (int i = 0; i < 3; ++i) {
+        pool.submit_tagged("sleep", [] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }).wait();
+        pool.submit_tagged("spin", [] {
+            spin_for(std::chrono::milliseconds(20));
+        }).wait();
+    }
+    pool.submit([] {}).wait();
+    
+    auto stats = pool.stats();
+    ASSERT_EQ(stats.tags.count("sleep"), 1u);
+    ASSERT_EQ(stats.tags.count("spin"), 1u);
+    ASSERT_EQ(stats.tags.count(""), 1u);
+    
+    const auto& sleep = stats.tags.at("sleep");
+    EXPECT_EQ(sleep.tasks, 3u);
+    EXPECT_EQ(sleep.blocking_tasks, 3u);
+    EXPECT_TRUE(sleep.likely_blocking());
+    EXPECT_LT(sleep.cpu_time, sleep.wall_time);
+    
+    const auto& spin = stats.tags.at("spin");
+    EXPECT_EQ(spin.tasks, 3u);
+    EXPECT_GT(spin.cpu_ratio(), sleep.cpu_ratio());
+    EXPECT_GT(stats.total_cpu_time.count(), 0);
+}
+
+TEST_F(StatsTest, BlockingUsesConfiguredThreshold) {
+    tp::PoolConfig config;
+    config.num_threads = 1;
+    config.sample_cpu_time = true;
+    config.blocking_threshold = 0.0;
+    tp::ThreadPool pool(config);
+    
+    pool.submit_tagged("sleep", [] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }).wait();
+    pool.submit([] {}).wait();
+    
+    const auto sleep = pool.stats().tags.at("sleep");
+    EXPECT_EQ(sleep.blocking_tasks, 0u);
+    EXPECT_DOUBLE_EQ(sleep.blocking_threshold, 0.0);
+    EXPECT_FALSE(sleep.likely_blocking());
+    EXPECT_TRUE(sleep.likely_blocking(0.5));
+}
+#endif
+
+TEST_F(StatsTest, TaggedTaskReturnsValue) {
+    tp::ThreadPool pool(2);
+    auto future = pool.submit_tagged("math", [](int a, int b) { return a + b; }, 2, 3);
+    EXPECT_EQ(future.get(), 5);
+}
+
+TEST_F(StatsTest, LockInstrumentationDisabledByDefault) {
+    tp::ThreadPool pool(2);
+    pool.submit([] {}).wait();
+    
+    auto stats = pool.stats();
+    EXPECT_EQ(stats.global_queue_lock.acquisitions, 0u);
+    ASSERT_EQ(stats.local_queue_locks.size(), 2u);
+    EXPECT_EQ(stats.local_queue_locks[0].acquisitions, 0u);
+}
+
+TEST_F(StatsTest, CountsQueueLockAcquisitions) {
+    tp::PoolConfig config;
+    config.num_threads = 2;
+    config.instrument_locks = true;
+    tp::ThreadPool pool(config);
+    
+    for (int i = 0; i < 100; ++i) {
+        pool.submit([] {}).wait();
+    }
+    
+    auto stats = pool.stats();
+    EXPECT_GE(stats.global_queue_lock.acquisitions, 100u);
+    EXPECT_LE(stats.global_queue_lock.contended, stats.global_queue_lock.acquisitions);
+    ASSERT_EQ(stats.local_queue_locks.size(), 2u);
+    EXPECT_GT(stats.local_queue_locks[0].acquisitions + stats.local_queue_locks[1].acquisitions, 0u);
+}
+
+TEST_F(StatsTest, InstrumentedMutexTimesContendedPath) {
+    tp::InstrumentedMutex mutex;
+    mutex.set_instrumented(true);
+    
+    auto holder = mutex.acquire();
+    std::promise<void> arriving;
+    std::thread waiter([&mutex, &arriving] {
+        arriving.set_value();
+        auto lock = mutex.acquire();
+    });
+    
+    // Keep holding well after the waiter is about to block on the lock
+    arriving.get_future().wait();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    holder.unlock();
+    waiter.join();
+    
+    auto stats = mutex.stats();
+    EXPECT_EQ(stats.acquisitions, 2u);
+    EXPECT_EQ(stats.contended, 1u);
+    EXPECT_GT(stats.wait_time.count(), 0);
+    EXPECT_DOUBLE_EQ(stats.contention_rate(), 0.5);
+}
@@ -0,0 +1,226 @@
+#include <threadpool/threadpool.hpp>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <numeric>
+#include <random>
+
+TEST(WorkerTest, ScratchRewoundAfterEachTask) {
+    tp::ThreadPool pool(1);
+    
+    size_t used_inside = pool.submit([] {
+        (void)tp::this_worker::scratch().allocate(1000);
+        return tp::this_worker::scratch().used();
+    }).get();
+    EXPECT_GE(used_inside, 1000u);
+    
+    size_t used_next = pool.submit([] {
+        return tp::this_worker::scratch().used();
+    }).get();
+    EXPECT_EQ(used_next, 0u);
+}
+
+TEST(WorkerTest, ScratchAllocationsAreAligned) {
+    tp::ScratchArena arena;
+    
+    for (size_t alignment : {1u, 2u, 8u, 16u, 64u, 4096u}) {
+        (void)arena.allocate(3);
+        void* p = arena.allocate(24, alignment);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % alignment, 0u) << alignment;
+    }
+}
+
+TEST(WorkerTest, ScratchConsolidatesOverflowBlocks) {
+    tp::ScratchArena arena;
+    
+    // Overflow the first block several times
+    for (int i = 0; i < 8; ++i) {
+        std::memset(arena.allocate(tp::ScratchArena::initial_block_size / 2), i, 16);
+    }
+    size_t capacity = arena.capacity();
+    EXPECT_GT(capacity, tp::ScratchArena::initial_block_size);
+    
+    // After a reset the same pattern fits without growing
+    arena.reset();
+    EXPECT_EQ(arena.used(), 0u);
+    for (int i = 0; i < 8; ++i) {
+        (void)arena.allocate(tp::ScratchArena::initial_block_size / 2);
+    }
+    EXPECT_EQ(arena.capacity(), capacity);
+}
+
+TEST(WorkerTest, NestedTaskKeepsOuterScratch) {
+    tp::ThreadPool pool(1);
+    
+    bool intact = pool.submit([&pool] {
+        auto* outer = static_cast<unsigned char*>(tp::this_worker::scratch().allocate(256));
+        std::memset(outer, 0xAB, 256);
+        
+        auto inner = pool.submit([] {
+            auto* mine = static_cast<unsigned char*>(tp::this_worker::scratch().allocate(256));
+            std::memset(mine, 0xCD, 256);
+        });
+        pool.wait_helping(inner);
+        
+        // The inner task must not have been handed the outer task's memory
+        auto* again = static_cast<unsigned char*>(tp::this_worker::scratch().allocate(256));
+        std::memset(again, 0xEF, 256);
+        for (size_t i = 0; i < 256; ++i) {
+            if (outer[i] != 0xAB) {
+                return false;
+            }
+        }
+        return true;
+    }).get();
+    
+    EXPECT_TRUE(intact);
+}
+
+#if defined(THREADPOOL_HAS_PMR)
+TEST(WorkerTest, ScratchAsMemoryResource) {
+    tp::ThreadPool pool(2);
+    
+    auto future = pool.submit([] {
+        std::pmr::vector<int> values(&tp::this_worker::scratch());
+        for (int i = 0; i < 10000; ++i) {
+            values.push_back(i);
+        }
+        return std::accumulate(values.begin(), values.end(), 0L);
+    });
+    
+    EXPECT_EQ(future.get(), 49995000L);
+}
+#endif
+
+TEST(WorkerTest, WorkerLocalCountsWithoutSharing) {
+    tp::ThreadPool pool(4);
+    tp::WorkerLocal<size_t> counts(pool);
+    
+    tp::parallel_for(pool, 0, 1000, [&counts](size_t) {
+        ++counts.local();
+    });
+    
+    EXPECT_EQ(counts.combine(std::plus<size_t>()), 1000u);
+    EXPECT_GE(counts.instances(), 1u);
+    EXPECT_LE(counts.instances(), pool.size());
+}
+
+TEST(WorkerTest, WorkerLocalCollectsFromExternalThreads) {
+    tp::ThreadPool pool(2);
+    tp::WorkerLocal<std::vector<int>> items(pool);
+    
+    items.local().push_back(-1);  // calling thread is not a worker
+    auto future = pool.submit([&items] { items.local().push_back(1); });
+    future.wait();
+    
+    std::vector<int> all;
+    items.for_each([&all](std::vector<int>& v) {
+        all.insert(all.end(), v.begin(), v.end());
+    });
+    std::sort(all.begin(), all.end());
+    EXPECT_EQ(all, (std::vector<int>{-1, 1}));
+}
+
+TEST(WorkerTest, WorkerLocalUsesInitAndClear) {
+    tp::ThreadPool pool(2);
+    tp::WorkerLocal<int> values(pool, [] { return 10; });
+    
+    EXPECT_EQ(values.combine(std::plus<int>()), 10);  // no instances yet
+    pool.submit([&values] { values.local() += 1; }).wait();
+    EXPECT_EQ(values.combine(std::plus<int>()), 11);
+    
+    values.clear();
+    EXPECT_EQ(values.instances(), 0u);
+}
+
+TEST(WorkerTest, IdInsideAndOutsidePool) {
+    EXPECT_FALSE(tp::this_worker::id().has_value());
+    
+    tp::ThreadPool pool(3);
+    auto id = pool.submit([] { return tp::this_worker::id(); }).get();
+    ASSERT_TRUE(id.has_value());
+    EXPECT_LT(*id, pool.size());
+}
+
+TEST(WorkerTest, StartAndStopHooksRunOncePerWorker) {
+    std::mutex mutex;
+    std::vector<size_t> started;
+    std::vector<size_t> stopped;
+    std::atomic<bool> ids_match{true};
+    
+    tp::PoolConfig config;
+    config.num_threads = 3;
+    config.on_worker_start = [&](size_t worker_id) {
+        if (tp::this_worker::id() != worker_id) {
+            ids_match = false;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        started.push_back(worker_id);
+    };
+    config.on_worker_stop = [&](size_t worker_id) {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopped.push_back(worker_id);
+    };
+    
+    {
+        tp::ThreadPool pool(config);
+        pool.submit([] {}).wait();
+    }
+    
+    std::sort(started.begin(), started.end());
+    std::sort(stopped.begin(), stopped.end());
+    EXPECT_EQ(started, (std::vector<size_t>{0, 1, 2}));
+    EXPECT_EQ(stopped, (std::vector<size_t>{0, 1, 2}));
+    EXPECT_TRUE(ids_match);
+}
+
+TEST(WorkerTest, FastRngIsDeterministicPerSeed) {
+    tp::FastRng a(7), b(7), c(8);
+    bool differs = false;
+    for (int i = 0; i < 100; ++i) {
+        uint64_t x = a();
+        EXPECT_EQ(x, b());
+        differs = differs || x != c();
+    }
+    EXPECT_TRUE(differs);
+    
+    std::uniform_int_distribution<int> dist(1, 6);
+    for (int i = 0; i < 1000; ++i) {
+        int roll = dist(a);
+        EXPECT_GE(roll, 1);
+        EXPECT_LE(roll, 6);
+    }
+}
+
+TEST(WorkerTest, SeededPoolGivesReproducibleTaskStreams) {
+    auto draw = [] {
+        tp::PoolConfig config;
+        config.num_threads = 3;
+        config.rng_seed = 42;
+        tp::ThreadPool pool(config);
+        
+        std::vector<std::future<uint64_t>> futures;
+        for (int i = 0; i < 20; ++i) {
+            futures.push_back(pool.submit([] { return tp::this_worker::rng()(); }));
+        }
+        std::vector<uint64_t> values;
+        for (auto& f : futures) {
+            values.push_back(f.get());
+        }
+        return values;
+    };
+    
+    std::vector<uint64_t> first = draw();
+    EXPECT_EQ(first, draw());
+    std::sort(first.begin(), first.end());
+    EXPECT_EQ(std::unique(first.begin(), first.end()), first.end());
+}
+
+TEST(WorkerTest, UnseededThreadsGetDistinctStreams) {
+    tp::ThreadPool pool(2);
+    uint64_t worker_value = pool.submit([] { return tp::this_worker::rng()(); }).get();
+    EXPECT_NE(worker_value, tp::this_worker::rng()());
+}